@@ -0,0 +1,55 @@
+#!/bin/sh
+################################################################################
+# Benchmark of the time taken by 'myshell' to launch an external command
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Executes a batch file of N '/bin/true' commands, timed by 'date' commands at
+# either end, with programs launched directly by the shell and by the fork
+# server (--zygote), first by a newly started shell and then by a shell which
+# has grown by holding a large variable.
+#
+# Usage: spawn_latency.sh [myshell] [N] [size of the variable in bytes]
+#
+# Build 'myshell' with 'make fork' to compare the fork server with fork/exec
+# instead of posix_spawn.
+################################################################################
+
+shell=${1:-./myshell}
+count=${2:-2000}
+size=${3:-268435456}
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+# Create a batch file, which first grows the shell if $2 is 'yes'
+make_batch() {
+    {
+        [ "$2" = yes ] && echo "BIG=\$(head -c $size /dev/zero | tr -c x x)"
+        echo "date +%s%N"
+        i=0
+        while [ $i -lt "$count" ]; do
+            echo "/bin/true"
+            i=$((i + 1))
+        done
+        echo "date +%s%N"
+        echo "echo" # the last command would otherwise replace the shell
+    } > "$1"
+}
+
+# Print the average time (in microseconds) taken to launch a command
+measure() {
+    batch=$1
+    shift
+    set -- $("$shell" "$@" "$batch")
+    echo $((($2 - $1) / count / 1000))
+}
+
+make_batch "$dir/small" no
+make_batch "$dir/large" yes
+
+echo "Launching $count commands with $shell"
+printf '%-32s %12s %12s\n' "" "direct (us)" "zygote (us)"
+printf '%-32s %12s %12s\n' "newly started shell" "$(measure "$dir/small")" "$(measure "$dir/small" --zygote)"
+printf '%-32s %12s %12s\n' "shell holding $((size / 1048576)) MiB" "$(measure "$dir/large")" "$(measure "$dir/large" --zygote)"
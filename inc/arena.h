@@ -0,0 +1,52 @@
+/*
+ * arena.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains a bump allocator for memory which is only required while
+ * a single command line is processed.
+ */
+#ifndef __ARENA_H_
+#define __ARENA_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_BLOCK_SIZE    4096 // size of the first block of an arena
+#define ARENA_ALIGNMENT     16 // alignment of each allocation (must be a power of two)
+
+typedef struct arena_block {
+    struct arena_block * next; // the previously allocated block
+    size_t size; // number of bytes in data
+    size_t used; // number of bytes of data which have been allocated
+    unsigned char data[]; // the memory available for allocation
+} arena_block;
+
+typedef struct {
+    arena_block * block; // the block from which memory is currently allocated
+    unsigned long allocations; // number of allocations since the arena was reset
+    size_t bytes; // number of bytes allocated since the arena was reset
+    unsigned long heap_allocations; // number of blocks allocated from the heap since the arena was reset
+    unsigned long total_heap_allocations; // number of blocks allocated from the heap in total
+} arena;
+
+extern arena line_arena; // memory for the current command line
+
+// Prepare an arena for use
+void arena_init(arena *);
+
+// Allocate memory from an arena
+void * arena_alloc(arena *, const size_t);
+
+// Release all memory allocated from an arena, keeping its blocks for reuse
+void arena_reset(arena *);
+
+// Free all of the blocks of an arena
+void arena_free(arena *);
+
+// Allocate a new block for an arena from the heap
+arena_block * arena_new_block(arena *, const size_t);
+
+#endif // #ifndef __ARENA_H_
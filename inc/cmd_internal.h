@@ -1,61 +1,139 @@
-/*
- * cmd_intenal.h
- *
- * Author: Joshua Spence
- * SID:    308216350
- *
- * This file contains the internal shell functions.
- */
-#ifndef __CMD_INTERNAL_H_
-#define __CMD_INTERNAL_H_
-
-#include <stdio.h>
-#include <unistd.h>
-#include <sys/wait.h>
-#include <termios.h>
-
-#include "utility.h"
-#include "strings.h"
-
-#define EXIT_STATUS_CONTINUE    0 // continue execution of shell
-#define EXIT_STATUS_QUIT        1 // quit the shell
-
-extern process_information proc_info; // information about child processes
-extern FILE * input_redir; // file for input redirection (stdin if null)
-extern FILE * output_redir; // file for output redirection (stdout if null)
-extern char * path; // path to the executable
-#ifdef DEBUG
-extern boolean debug; // is debug mode active?
-#endif // #ifdef DEBUG
-extern char ** environ; // pointer to environment variables
-
-// Forward declarations (to fix compilation warnings)
-int setenv(char *, char *, int);
-int fileno(FILE *);
-char * ctermid(char *);
-
-// Change the current working directory to the specified directory
-int change_directory(const char *);
-
-// Clear the terminal screen
-int clear_screen(void);
-
-// List the contents of a directory
-int list_directory(const char *);
-
-// Print the environment variables
-int print_environment(void);
-
-// Echo a comment to the terminal
-int echo(const char **);
-
-// Get help
-int help(const char *);
-
-// Pause the shell until a specified key is pressed
-int pause(void);
-
-// Quit the shell
-int quit(void);
-
-#endif // #ifndef __CMD_INTERNAL_H_
+/*
+ * cmd_intenal.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the internal shell functions.
+ */
+#ifndef __CMD_INTERNAL_H_
+#define __CMD_INTERNAL_H_
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <termios.h>
+
+#include "jobs.h"
+#include "launch.h"
+#include "listing.h"
+#include "pager.h"
+#include "path_cache.h"
+#include "utility.h"
+#include "writer.h"
+#include "strings.h"
+
+#define EXIT_STATUS_CONTINUE    0 // continue execution of shell
+#define EXIT_STATUS_QUIT        1 // quit the shell
+
+// Capabilities of internal commands
+#define BUILTIN_BACKGROUND      0x01 // may be executed in the background (in a child process, so it must not change the state of the shell)
+#define BUILTIN_INPUT           0x02 // accepts input redirection
+#define BUILTIN_OUTPUT          0x04 // accepts output redirection
+#define BUILTIN_SHELL           0x08 // changes the state of the shell (so must not be executed in a child process of a parallel batch)
+
+/*
+ * The internal commands, as X(command, name, function, capabilities). Each
+ * function is called with the arguments following the command and the writer
+ * to which its output is written, and returns an exit status indicating to the
+ * shell what action should be taken.
+ */
+#define BUILTINS(X) \
+    X(CHANGE_DIRECTORY_COMMAND,     CHANGE_DIRECTORY_CMD_NAME,  change_directory,   BUILTIN_OUTPUT | BUILTIN_SHELL) \
+    X(CLEAR_SCREEN_COMMAND,         CLEAR_SCREEN_CMD_NAME,      clear_screen,       BUILTIN_BACKGROUND) \
+    X(LIST_DIRECTORY_COMMAND,       LIST_DIRECTORY_CMD_NAME,    list_directory,     BUILTIN_BACKGROUND | BUILTIN_OUTPUT) \
+    X(PRINT_ENVIRONMENT_COMMAND,    PRINT_ENVIRONMENT_CMD_NAME, print_environment,  BUILTIN_BACKGROUND | BUILTIN_OUTPUT) \
+    X(ECHO_COMMAND,                 ECHO_CMD_NAME,              echo,               BUILTIN_BACKGROUND | BUILTIN_INPUT | BUILTIN_OUTPUT) \
+    X(HELP_COMMAND,                 HELP_CMD_NAME,              help,               BUILTIN_BACKGROUND | BUILTIN_OUTPUT) \
+    X(HASH_COMMAND,                 HASH_CMD_NAME,              hash,               BUILTIN_OUTPUT | BUILTIN_SHELL) \
+    X(PAUSE_COMMAND,                PAUSE_CMD_NAME,             pause_shell,        BUILTIN_SHELL) \
+    X(QUIT_COMMAND,                 QUIT_CMD_NAME,              quit,               BUILTIN_SHELL) \
+    X(EXEC_COMMAND,                 EXEC_CMD_NAME,              exec_shell,         BUILTIN_INPUT | BUILTIN_OUTPUT | BUILTIN_SHELL) \
+    X(JOBS_COMMAND,                 JOBS_CMD_NAME,              list_jobs,          BUILTIN_OUTPUT | BUILTIN_SHELL) \
+    X(WAIT_COMMAND,                 WAIT_CMD_NAME,              wait_for_jobs,      BUILTIN_SHELL) \
+    X(FOREGROUND_COMMAND,           FOREGROUND_CMD_NAME,        foreground_job,     BUILTIN_SHELL) \
+    X(BACKGROUND_COMMAND,           BACKGROUND_CMD_NAME,        background_job,     BUILTIN_OUTPUT | BUILTIN_SHELL) \
+    X(EXPORT_COMMAND,               EXPORT_CMD_NAME,            export_variables,   BUILTIN_OUTPUT | BUILTIN_SHELL) \
+    X(UNSET_COMMAND,                UNSET_CMD_NAME,             unset_variables,    BUILTIN_SHELL) \
+    BUILTINS_DEBUG(X)
+
+#ifdef DEBUG
+#define BUILTINS_DEBUG(X) \
+    X(DEBUG_COMMAND,                DEBUG_CMD_NAME,             debug_mode,         BUILTIN_SHELL)
+#else
+#define BUILTINS_DEBUG(X)
+#endif // #ifdef DEBUG
+
+typedef struct {
+    const char * command; // the command
+    const char * name; // the full name of the command
+    int (* function)(char **, writer *); // the function which executes the command
+    unsigned int capabilities; // what the command supports (BUILTIN_BACKGROUND, BUILTIN_INPUT and BUILTIN_OUTPUT)
+} builtin;
+
+extern process_information proc_info; // information about child processes
+extern char * path; // path to the executable
+extern char * home; // the directory from which the shell was started
+extern boolean interactive; // is the shell reading commands from a terminal?
+#ifdef DEBUG
+extern boolean debug; // is debug mode active?
+#endif // #ifdef DEBUG
+
+// Change the current working directory to the specified directory
+int change_directory(char **, writer *);
+
+// Clear the terminal screen
+int clear_screen(char **, writer *);
+
+// List the contents of a directory
+int list_directory(char **, writer *);
+
+// Display an error message that a directory could not be listed
+void error_list_directory(const char *);
+
+// Print the environment variables
+int print_environment(char **, writer *);
+
+// Echo a comment to the terminal
+int echo(char **, writer *);
+
+// Get help
+int help(char **, writer *);
+
+// Remember or forget the full paths to commands
+int hash(char **, writer *);
+
+// Pause the shell until a specified key is pressed
+int pause_shell(char **, writer *);
+
+// Quit the shell
+int quit(char **, writer *);
+
+// Replace the shell with a command
+int exec_shell(char **, writer *);
+
+// Replace the shell with an external command
+int replace_shell(char **, const boolean);
+
+// List the jobs
+int list_jobs(char **, writer *);
+
+// Wait for jobs to finish
+int wait_for_jobs(char **, writer *);
+
+// Continue a job in the foreground
+int foreground_job(char **, writer *);
+
+// Continue a stopped job in the background
+int background_job(char **, writer *);
+
+// Export variables to child processes
+int export_variables(char **, writer *);
+
+// Remove variables
+int unset_variables(char **, writer *);
+
+// Display an error message that an argument is not a valid variable name
+void error_variable_name(const char *, const char *);
+
+#endif // #ifndef __CMD_INTERNAL_H_
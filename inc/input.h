@@ -0,0 +1,51 @@
+/*
+ * input.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to split the input of the shell into
+ * lines without copying it through stdio.
+ */
+#ifndef __INPUT_H_
+#define __INPUT_H_
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "utility.h"
+
+#define INPUT_BLOCK_SIZE    65536 // initial size of the buffer used when the input cannot be mapped into memory
+
+typedef struct {
+    int fd; // the file descriptor from which input is read (-1 if the input is a string)
+    boolean mapped; // is the whole file mapped into memory? (if so, lines remain valid until input_close)
+    char * data; // the mapped file, or the read buffer
+    size_t size; // length of the mapped file, or size of the read buffer
+    size_t start; // offset in data of the next line
+    size_t scanned; // offset in data up to which no new-line character has been found
+    size_t end; // number of bytes of data which are valid
+    boolean eof; // has the end of the input been reached?
+} input_source;
+
+// Prepare to read lines from a file descriptor
+void input_open(input_source *, const int);
+
+// Prepare to read lines from a string
+void input_open_string(input_source *, const char *, const size_t);
+
+// Get the next line of input
+const char * input_next_line(input_source *, size_t *);
+
+// Check whether the end of the input has been reached
+boolean input_at_end(const input_source *);
+
+// Release the memory used to read input
+void input_close(input_source *);
+
+#endif // #ifndef __INPUT_H_
@@ -0,0 +1,146 @@
+/*
+ * jobs.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the job table, which keeps track of the child processes
+ * launched by each command line.
+ */
+#ifndef __JOBS_H_
+#define __JOBS_H_
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "utility.h"
+#include "writer.h"
+#include "strings.h"
+
+#define JOB_RING_SIZE       64 // number of process statuses which the SIGCHLD handler can hold before they are processed
+
+// Job states
+#define JOB_RUNNING         0 // at least one process is running
+#define JOB_STOPPED         1 // no process is running and at least one process is stopped
+#define JOB_DONE            2 // all processes have terminated
+
+#define JOB_FAILURE_STATUS  W_EXITCODE(EXIT_FAILURE, 0) // status of an internal command which failed
+
+typedef struct {
+    pid_t pid; // process ID
+    int status; // status reported by waitpid
+    int state; // JOB_RUNNING, JOB_STOPPED or JOB_DONE
+} job_process;
+
+typedef struct {
+    unsigned int number; // the job number (0 if this entry is unused)
+    pid_t pgid; // process group of the job (0 if the job has no process group of its own)
+    char * command; // the command line which created the job
+    time_t started; // when the job was started
+    job_process * processes; // the processes of the job
+    unsigned int num_processes; // number of processes in the job
+    int state; // JOB_RUNNING, JOB_STOPPED or JOB_DONE
+    int status; // status of the last process of the job
+    boolean notified; // has the current state been reported to the user?
+    unsigned long sequence; // when the job was last started, stopped or put in the background (used to find the current job)
+} job;
+
+typedef struct {
+    pid_t pid; // process ID
+    int status; // status reported by waitpid
+} job_ring_entry;
+
+extern process_information proc_info; // information about child processes
+extern boolean interactive; // is the shell reading commands from a terminal?
+extern boolean job_control; // are jobs run in their own process groups?
+#ifdef DEBUG
+extern boolean debug; // is debug mode active?
+#endif // #ifdef DEBUG
+
+// Prepare the job table and install the SIGCHLD handler
+void jobs_setup(void);
+
+// Reap child processes (SIGCHLD handler)
+void jobs_sigchld_handler(int);
+
+// Process the statuses of child processes which have changed
+unsigned int jobs_update(void);
+
+// Wait for the status of a child process to change
+void jobs_wait_change(void);
+
+// Remove every job from the job table without waiting for it
+void jobs_clear(void);
+
+// Forget the statuses of processes which belong to no job
+void jobs_forget_unclaimed(void);
+
+// Convert a status reported by waitpid to an exit status
+int job_exit_status(const int);
+
+// Record a change in the status of a process
+void job_set_status(const pid_t, const int);
+
+// Create a job for a command
+job * job_create(const char *, size_t);
+
+// Add a process to a job
+void job_add_process(job *, const pid_t);
+
+// Remove a job from the job table
+void job_remove(job *);
+
+// Wait for a job to finish or stop, giving it the terminal if appropriate
+int job_wait(job *, const boolean);
+
+// Wait for every running job to finish or stop
+int jobs_wait_all(void);
+
+// Check whether any job has not yet finished
+boolean jobs_pending(void);
+
+// Report that a job has been started in the background
+void job_background(job *);
+
+// Continue a stopped job
+void job_continue(job *);
+
+// Find a job from a job specification
+job * job_find(const char *);
+
+// Find the current job
+job * job_current(void);
+
+// Print the state of a job
+void job_print(writer *, const job *);
+
+// Print the state of every job
+void jobs_print_all(writer *);
+
+// Report jobs which have finished or stopped since they were last reported
+void jobs_notify(void);
+
+// Get the process group in which a process should be launched
+pid_t job_process_group(const pid_t);
+
+// Prepare a forked child process to run as part of a job
+void job_child_setup(const pid_t, const boolean);
+
+// Put a newly launched child process in its process group
+void job_parent_setup(const pid_t, const pid_t);
+
+// Send a signal to every process of a job
+void job_signal(const job *, const int);
+
+// Display an error message that a job could not be found
+void error_no_such_job(const char *, const char *);
+
+#endif // #ifndef __JOBS_H_
@@ -0,0 +1,80 @@
+/*
+ * launch.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to launch and wait for child
+ * processes.
+ */
+#ifndef __LAUNCH_H_
+#define __LAUNCH_H_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "jobs.h"
+#include "redirect.h"
+#include "variables.h"
+#include "zygote.h"
+#include "utility.h"
+#include "strings.h"
+
+#define LAUNCH_ARG_STRLEN_PAGES 32 // maximum length (in pages) of a single argument
+#define LAUNCH_NOT_FOUND_STATUS 127 // exit status of a command which could not be found
+#define LAUNCH_FAILED_STATUS    126 // exit status of a command which could not be executed
+
+extern process_information proc_info; // information about child processes
+extern char * path; // path to the executable
+#ifdef DEBUG
+extern boolean debug; // is debug mode active?
+#endif // #ifdef DEBUG
+
+// Build the environment for a child process
+char ** build_environment(void);
+
+// Free an environment created by build_environment
+void free_environment(char **);
+
+// Get the environment for child processes
+char ** child_environment(void);
+
+// Forget the environment for child processes
+void child_environment_reset(void);
+
+// Launch a program in a child process
+pid_t launch_program(const char *, char **, const int, const int, const pid_t);
+
+// Replace the shell with a program
+void exec_program(const char *, char **, const boolean);
+
+// Calculate the space which an array of strings will occupy in a new process image
+size_t argument_size(char **);
+
+// Find the length of the longest string in an array of strings
+size_t longest_argument(char **);
+
+// Get the maximum space which the arguments and environment of a new process may occupy
+size_t argument_limit(void);
+
+// Get the maximum length of a single argument or environment string
+size_t argument_string_limit(void);
+
+// Display an error message that a program could not be launched
+void error_launch(const char *);
+
+// Wait for the most recently launched child process (unless it is running in the background)
+void wait_for_process(void);
+
+// Wait for a group of child processes (unless they are running in the background)
+void wait_for_processes(const pid_t *, const unsigned int);
+
+#endif // #ifndef __LAUNCH_H_
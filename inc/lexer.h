@@ -0,0 +1,68 @@
+/*
+ * lexer.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the lexer used to split a command line into arguments.
+ */
+#ifndef __LEXER_H_
+#define __LEXER_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // #ifdef __SSE2__
+
+#include "utility.h"
+#include "strings.h"
+
+// Character classes
+#define LEX_WORD        0 // character which is part of an argument
+#define LEX_SEPARATOR   1 // character which separates arguments (unless quoted)
+#define LEX_QUOTE       2 // quotation mark
+#define LEX_OPERATOR    3 // character which forms a token of its own (unless quoted)
+#define LEX_EXPANSION   4 // character which starts a variable expansion or command substitution
+#define LEX_GLOB        5 // wildcard of a pathname pattern (unless quoted), or GLOB_ESCAPE
+
+// Token flags (stored in the byte before each token)
+#define TOKEN_QUOTED    0x01 // the token contained quotation marks
+#define TOKEN_EXPAND    0x02 // the token contains EXPANSION_CHARACTER (see expand_arguments)
+#define TOKEN_GLOB      0x04 // the token contains a wildcard which was not quoted (see expand_pathnames)
+#define TOKEN_HEREDOC   0x08 // the token is the content of a here-document (see read_here_documents)
+
+#define LEX_MAX_SPECIAL 16 // maximum number of characters which are not LEX_WORD
+
+typedef struct {
+    const char * input; // next character to be read
+    const char * end; // end of the input
+    char * output; // next free byte of the token buffer
+} lexer;
+
+// Build the character class table
+void lexer_setup(void);
+
+// Calculate the size of the token buffer required for an input
+size_t lexer_buffer_size(const size_t);
+
+// Prepare to split an input into tokens
+void lexer_init(lexer *, const char *, const size_t, char *);
+
+// Get the next token from the input
+char * lexer_next(lexer *);
+
+// Find the length of a run of LEX_WORD characters
+size_t lexer_word_run(const char *, const char *);
+
+// Find the length of a command substitution
+size_t lexer_substitution_length(const char *, const char *);
+
+// Check whether a token contained no quotation marks
+boolean is_unquoted(const char *);
+
+// Remove the GLOB_ESCAPE characters from a pathname pattern
+size_t remove_escapes(char *);
+
+#endif // #ifndef __LEXER_H_
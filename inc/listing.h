@@ -0,0 +1,61 @@
+/*
+ * listing.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to produce a long directory listing
+ * (in the same format as 'ls -al') without executing another program.
+ */
+#ifndef __LISTING_H_
+#define __LISTING_H_
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "utility.h"
+#include "writer.h"
+#include "strings.h"
+
+#define LISTING_DENTS_SIZE      32768 // size of the buffer used to read directory entries
+#define LISTING_STATX_MASK      (STATX_TYPE | STATX_MODE | STATX_NLINK | STATX_UID | STATX_GID | STATX_MTIME | STATX_SIZE | STATX_BLOCKS) // file information required for the listing
+#define LISTING_RECENT_SECONDS  15778476 // files modified more recently than this (six months) show the time rather than the year
+
+typedef struct {
+    char * name; // name of the file
+    char * link; // target of a symbolic link (null if not a symbolic link)
+    struct statx info; // information about the file
+} listing_entry;
+
+// Write a long listing of a directory to a writer
+int write_directory_listing(const char *, writer *);
+
+// Read the names of all entries in a directory
+int listing_read_entries(const int, listing_entry **, unsigned int *, char **);
+
+// Get information about each entry in a directory
+void listing_stat_entries(const int, listing_entry *, const unsigned int);
+
+// Compare the names of two listing entries
+int listing_compare(const void *, const void *);
+
+// Format a single entry of a long listing
+int listing_format_entry(writer *, const listing_entry *, const int *, const time_t);
+
+// Get the name of a user
+const char * listing_user_name(const uid_t);
+
+// Get the name of a group
+const char * listing_group_name(const gid_t);
+
+#endif // #ifndef __LISTING_H_
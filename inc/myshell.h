@@ -1,81 +1,163 @@
-/*
- * myshell.h
- *
- * Author: Joshua Spence
- * SID:    308216350
- *
- * This is the header file for the 'myshell' shell.
- */
-#ifndef __MYSHELL_H_
-#define __MYSHELL_H_
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/wait.h>
-#include <string.h>
-#include <signal.h>
-
-#define MAX_ARGS 64 // maximum number of arguments (size of argument array)
-
-#include "cmd_internal.h"
-#include "utility.h"
-#include "strings.h"
-
-process_information proc_info; // information about child processes
-FILE * input_redir; // file for input redirection (stdin if null)
-FILE * output_redir; // file for output redirection (stdout if null)
-char * path; // path to the executable
-#ifdef DEBUG
-boolean debug; // is debug mode on?
-#endif // #ifdef DEBUG
-
-// Output the shell prompt
-void output_shell_prompt(const char *);
-
-// Reallocate memory for the input buffer if required
-char * get_input(char *, FILE *);
-
-// Check arguments for dont wait character
-void check_for_dont_wait(char **);
-
-// Check arguments for input redirection
-void check_for_input_redirection(char **);
-
-// Check arguments for output redirection
-void check_for_output_redirection(char **);
-
-// Process an external command by passing it the external shell
-int process_external_command(char **);
-
-// Display an error message that a command requiring an argument has been executed without an argument
-void error_no_argument(const char *);
-
-// Display an error message that a command has been specified with an unknown argument
-void error_unrecognised_argument(const char *, const char *);
-
-// Reset the process information
-void reset_process_information(void);
-
-// Main function to run the shell
-int main(int, char **);
-
-#ifdef DEBUG
-// Turns debug mode on or off
-int debug_mode(const boolean);
-
-// Display a debug message indicating that a command has been recognised
-void debug_command_recognised_message(const char *, const char *);
-
-// Display a debug message indicating that a command has been executed
-void debug_command_executed_message(const char *, const char *);
-
-// Display a debug message showing the input that has been read
-void debug_read_line_message(const char *);
-
-// Display a debug message showing the command and arguments that have been recognised and will be processed
-void debug_command_args_message(const char *, const char **);
-
-#endif // #ifdef DEBUG
-#endif // #ifndef __MYSHELL_H_
+/*
+ * myshell.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This is the header file for the 'myshell' shell.
+ */
+#ifndef __MYSHELL_H_
+#define __MYSHELL_H_
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <string.h>
+#include <signal.h>
+
+#include "cmd_internal.h"
+#include "launch.h"
+#include "lexer.h"
+#include "path_cache.h"
+#include "pathname.h"
+#include "reader.h"
+#include "redirect.h"
+#include "server.h"
+#include "variables.h"
+#include "utility.h"
+#include "strings.h"
+
+#define NUM_BUILTINS (sizeof(builtins) / sizeof(builtin)) // number of internal commands
+#define PARALLEL_WINDOW 4 // number of command lines of a parallel batch (per worker) which may be waiting to be output
+
+typedef struct {
+    job * j; // the job executing the command line (null if the slot is unused)
+    int output_fds[2]; // temporary files capturing stdout and stderr of the command line (-1 if not yet created)
+} parallel_slot;
+
+process_information proc_info; // information about child processes
+char * path; // path to the executable
+char * home; // the directory from which the shell was started
+boolean interactive; // is the shell reading commands from a terminal?
+boolean job_control; // are jobs run in their own process groups?
+const char * command_line; // the command line being executed (NOT null-terminated)
+size_t command_line_length; // length of the command line being executed
+int last_status; // exit status of the last command executed
+boolean last_line; // is the command line being executed the last of the input?
+boolean replace_last; // may the shell be replaced by the last command it executes?
+#ifdef DEBUG
+boolean debug; // is debug mode on?
+#endif // #ifdef DEBUG
+
+// Output the shell prompt
+void output_shell_prompt(const char *);
+
+// Get the next command line and split it into arguments
+char ** read_line(input_source *);
+
+// Execute the arguments of a command line
+int execute_line(char **);
+
+// Check whether every argument of a command is a variable assignment
+boolean is_assignment_command(char **);
+
+// Set the variables assigned by a command
+void process_assignments(char **);
+
+// Execute a single command (or pipeline) of a command line
+int execute_list_command(char **);
+
+// Build the text of a command as it is shown by the job table
+char * command_text(char **);
+
+// Execute the command lines of a batch file in parallel
+int process_parallel_batch(input_source *, const unsigned int, const boolean);
+
+// Check whether a command line must be executed by the shell itself
+boolean is_barrier_line(char **);
+
+// Launch a command line of a parallel batch in a child process
+boolean launch_parallel_line(parallel_slot *, char **);
+
+// Wait for the command line of a parallel batch slot and output its captured output
+int finish_parallel_slot(parallel_slot *);
+
+// Copy the contents of a temporary file to an output stream
+void copy_captured_output(const int, FILE *);
+
+// Check arguments for dont wait character
+void check_for_dont_wait(char **);
+
+// Execute a single internal or external command
+int execute_command(char **);
+
+// Build the index used to find internal commands
+void builtin_setup(void);
+
+// Find an internal command
+const builtin * find_builtin(const char *);
+
+// Process an external command by passing it the external shell
+int process_external_command(char **);
+
+// Launch an external command in a child process
+pid_t launch_command(char **, const int, const int, const pid_t);
+
+// Launch an internal command in a child process
+pid_t launch_internal_command(char **, const int, const int, const int, const pid_t);
+
+// Count the number of pipe characters in an argument array
+unsigned int count_pipes(char **);
+
+// Check whether an argument is the pipe character
+boolean is_pipe(const char *);
+
+// Check whether an argument is a command list operator
+boolean is_list_operator(const char *);
+
+// Check whether a command is an internal command
+boolean is_internal_command(const char *);
+
+// Execute a pipeline of commands
+int process_pipeline(char **);
+
+// Display an error message that a command requiring an argument has been executed without an argument
+void error_no_argument(const char *);
+
+// Display an error message that a command has been specified with an unknown argument
+void error_unrecognised_argument(const char *, const char *);
+
+// Reset the process information
+void reset_process_information(void);
+
+// Main function to run the shell
+int main(int, char **);
+
+// Execute the command lines of the shell
+int run_shell(int, char **);
+
+#ifdef DEBUG
+// Turns debug mode on or off
+int debug_mode(char **, writer *);
+
+// Display a debug message indicating that a command has been recognised
+void debug_command_recognised_message(const char *, const char *);
+
+// Display a debug message indicating that a command has been executed
+void debug_command_executed_message(const char *, const char *);
+
+// Display a debug message showing the input that has been read
+void debug_read_line_message(const char *, size_t);
+
+// Display a debug message showing the command and arguments that have been recognised and will be processed
+void debug_command_args_message(const char *, const char **);
+
+// Display a debug message showing how much memory was allocated from an arena
+void debug_arena_message(const arena *);
+
+#endif // #ifdef DEBUG
+#endif // #ifndef __MYSHELL_H_
@@ -0,0 +1,61 @@
+/*
+ * pager.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to display the manual for the shell
+ * without executing another program.
+ */
+#ifndef __PAGER_H_
+#define __PAGER_H_
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "utility.h"
+#include "strings.h"
+
+#define MANUAL_ENTRY_INDENT     7 // indentation of the command entries in the manual
+#define PAGER_DEFAULT_ROWS      24 // number of rows to assume if the terminal size is unknown
+
+typedef struct {
+    const char * name; // the heading or command name (not null-terminated)
+    size_t name_length; // length of the name
+    const char * start; // start of the section
+    const char * end; // end of the section
+    boolean is_command; // is this the entry for a command (rather than a heading)?
+} manual_section;
+
+typedef struct {
+    const char * data; // the memory mapped manual
+    size_t size; // size of the manual
+    manual_section * sections; // index of the headings and command entries
+    unsigned int num_sections; // number of sections in the index
+} manual_file;
+
+// Memory map the manual and index its sections
+const manual_file * manual_load(const char *);
+
+// Index the headings and command entries of the manual
+void manual_index(manual_file *);
+
+// Find a section of the manual
+const manual_section * manual_find(const manual_file *, const char *);
+
+// Display text, one screen at a time if appropriate
+int page(const char *, const size_t, const int, const boolean);
+
+// Wait for a key to be pressed at the terminal
+int pager_wait_for_key(void);
+
+#endif // #ifndef __PAGER_H_
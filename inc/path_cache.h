@@ -0,0 +1,66 @@
+/*
+ * path_cache.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains a hash table which remembers the full path to each
+ * external command, so that the directories in the PATH environment variable
+ * need not be searched every time a command is executed.
+ */
+#ifndef __PATH_CACHE_H_
+#define __PATH_CACHE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "utility.h"
+#include "writer.h"
+#include "variables.h"
+#include "strings.h"
+
+#define PATH_CACHE_BUCKETS 64 // number of buckets in the hash table (must be a power of two)
+#define DEFAULT_PATH "/bin:/usr/bin" // directories to search if PATH is not set
+#define PATH_CACHE_NOT_FOUND_SECONDS 2 // number of seconds for which a command which could not be found is remembered
+
+typedef struct path_cache_entry {
+    char * name; // the command name
+    char * path; // the full path to the command (null if the command was not found)
+    time_t searched; // when PATH was last searched for the command
+    unsigned int hits; // number of times the command has been executed since it was found
+    struct path_cache_entry * next; // next entry in the same bucket
+} path_cache_entry;
+
+#ifdef DEBUG
+extern boolean debug; // is debug mode active?
+#endif // #ifdef DEBUG
+
+// Calculate the hash of a command name
+unsigned int path_cache_hash(const char *);
+
+// Search the directories in PATH for a command
+char * path_cache_search(const char *, const char *);
+
+// Find the full path to a command which is about to be executed
+const char * path_cache_lookup(const char *);
+
+// Find the full path to a command, without counting it as a use of the command
+const char * path_cache_find(const char *);
+
+// Get the entry of a command in the hash table
+path_cache_entry * path_cache_get(const char *);
+
+// Forget the full path to a single command
+void path_cache_remove(const char *);
+
+// Forget the full path to all commands
+void path_cache_clear(void);
+
+// Print all remembered commands to a file
+void path_cache_print(writer *);
+
+#endif // #ifndef __PATH_CACHE_H_
@@ -0,0 +1,78 @@
+/*
+ * pathname.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the expansion of pathname patterns (such as "*.c") in the
+ * arguments of a command to the names of the matching files.
+ */
+#ifndef __PATHNAME_H_
+#define __PATHNAME_H_
+
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "arena.h"
+#include "lexer.h"
+#include "utility.h"
+#include "strings.h"
+
+#define PATHNAME_MATCHES    16 // initial number of arguments for which space is allocated
+
+#ifdef DEBUG
+extern boolean debug; // is debug mode active?
+#endif // #ifdef DEBUG
+
+typedef struct pathname_directory {
+    char * path; // the directory, as it appears in the pattern (the current directory if empty)
+    char ** names; // the names of the entries of the directory, in sorted order (each preceded by a byte holding its type)
+    unsigned int num_names; // number of entries of names
+    struct pathname_directory * next; // the next directory which has been read
+} pathname_directory;
+
+typedef struct {
+    arena * memory; // the arena from which memory is allocated
+    pathname_directory * directories; // the directories which have been read while expanding the arguments
+    char ** args; // the expanded arguments
+    unsigned int num_args; // number of entries of args which are used
+    unsigned int capacity; // number of entries allocated for args
+    char path[PATH_MAX]; // the path being matched
+} pathname_expansion;
+
+// Expand the pathname patterns in the arguments of a command
+char ** expand_pathnames(arena *, char **);
+
+// Find the pathnames which match a pattern
+void pathname_glob(pathname_expansion *, size_t, const char *);
+
+// Get the sorted entries of a directory
+pathname_directory * pathname_list(pathname_expansion *, const size_t);
+
+// Check whether a directory entry may be a directory
+boolean is_directory_type(const unsigned char);
+
+// Add a copy of a pathname to the expanded arguments
+void pathname_add(pathname_expansion *, const char *, const size_t);
+
+// Append an argument to the expanded arguments
+void pathname_append(pathname_expansion *, char *);
+
+// Check whether part of a pattern contains wildcards
+boolean has_wildcards(const char *, const char *);
+
+// Check whether a name matches part of a pattern
+boolean wildcard_match(const char *, const char *, const char *);
+
+// Check whether a character matches a bracket expression of a pattern
+int bracket_match(const char *, const char *, const char, const char **);
+
+// Compare two strings (for qsort)
+int pathname_compare(const void *, const void *);
+
+#endif // #ifndef __PATHNAME_H_
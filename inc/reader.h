@@ -0,0 +1,82 @@
+/*
+ * reader.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to read command lines and split them
+ * into arguments, including the batch reader, which reads and tokenizes
+ * command lines in a separate thread while earlier command lines execute.
+ */
+#ifndef __READER_H_
+#define __READER_H_
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "input.h"
+#include "lexer.h"
+#include "utility.h"
+#include "strings.h"
+
+#define READER_RING_SIZE    64 // number of command lines which the batch reader may read ahead
+#define READER_SPIN         1000 // number of times to check a semaphore before sleeping on it (if there is more than one processor)
+#define HERE_DOCUMENT_SIZE  4096 // initial size of the buffer into which a here-document is read
+
+typedef struct {
+    arena memory; // memory for the command line and its arguments
+    const char * line; // the command line, which is NOT null-terminated (null at the end of the input)
+    size_t length; // length of the command line
+    char ** args; // the arguments of the command line
+    boolean last; // is this the last command line of the input?
+} reader_command;
+
+typedef struct {
+    input_source * input; // the input from which command lines are read
+    pthread_t thread; // the thread which reads command lines
+    reader_command commands[READER_RING_SIZE]; // command lines which have been read, oldest first from tail
+    unsigned int head; // number of command lines produced (only used by the reader thread)
+    unsigned int tail; // number of command lines consumed (only used by the shell)
+    sem_t filled; // number of command lines which are ready to be consumed
+    sem_t available; // number of entries of commands which may be filled
+    boolean holding; // is the shell still using the command line at tail?
+    boolean finished; // has the end of the input been reached by the shell?
+    boolean running; // has the thread been started?
+    unsigned int spin; // number of times to check a semaphore before sleeping on it
+    volatile sig_atomic_t stopping; // should the thread stop reading?
+} reader;
+
+// Read a line of input
+const char * get_input(input_source *, arena *, size_t *);
+
+// Split a command line into arguments
+char ** tokenize_line(arena *, const char *, const size_t);
+
+// Read the here-documents of a command line
+void read_here_documents(input_source *, arena *, char **);
+
+// Read the lines of a here-document
+char * read_here_document(input_source *, arena *, const char *, const boolean);
+
+// Start reading command lines in a separate thread
+void reader_start(reader *, input_source *);
+
+// Get the next command line read by the batch reader
+reader_command * reader_next(reader *);
+
+// Wait for a semaphore of the batch reader
+void reader_wait(sem_t *, const unsigned int);
+
+// Stop the batch reader and release its memory
+void reader_stop(reader *);
+
+// Read and tokenize command lines (thread function of the batch reader)
+void * reader_thread(void *);
+
+#endif // #ifndef __READER_H_
@@ -0,0 +1,102 @@
+/*
+ * redirect.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the redirection of the file descriptors of a command to
+ * files, here-documents and other file descriptors.
+ */
+#ifndef __REDIRECT_H_
+#define __REDIRECT_H_
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "arena.h"
+#include "jobs.h"
+#include "lexer.h"
+#include "utility.h"
+#include "strings.h"
+
+#define REDIRECT_MAX        16 // maximum number of redirections of a command
+#define REDIRECT_MAX_FD     9 // largest file descriptor of a command which may be redirected
+#define REDIRECT_SHELL_FD   10 // lowest file descriptor used by the shell for an opened file (so that it is never the target of a redirection)
+#define REDIRECT_NOT_SAVED  -2 // a file descriptor of the shell which was not changed by redirect_apply
+
+// Redirection operators
+#define REDIRECT_NONE       0 // the argument is not a redirection
+#define REDIRECT_INPUT      1 // n<file
+#define REDIRECT_OUTPUT     2 // n>file
+#define REDIRECT_APPEND     3 // n>>file
+#define REDIRECT_DUPLICATE  4 // n>&m or n<&m (or n>&- to close)
+#define REDIRECT_BOTH       5 // &>file
+#define REDIRECT_BOTH_APPEND 6 // &>>file
+#define REDIRECT_HERE_STRING 7 // <<< string
+#define REDIRECT_HERE_DOCUMENT 8 // a here-document (see read_here_documents)
+#define REDIRECT_NO_DELIMITER 9 // << without a delimiter
+
+typedef struct {
+    int fd; // the file descriptor of the command which is redirected
+    int source; // the file descriptor of the shell which it becomes a copy of (-1 if it is closed)
+} redirection;
+
+typedef struct {
+    redirection entries[REDIRECT_MAX]; // the redirections, in the order in which they are applied
+    unsigned int num_entries; // number of entries which are used
+    int opened[REDIRECT_MAX]; // the files which have been opened for the redirections
+    unsigned int num_opened; // number of entries of opened which are used
+} redirection_table;
+
+extern redirection_table redirects; // the redirections of the command being executed
+extern process_information proc_info; // information about child processes
+#ifdef DEBUG
+extern boolean debug; // is debug mode active?
+#endif // #ifdef DEBUG
+
+// Remove the redirections from the arguments of a command and open their files
+boolean redirect_parse(redirection_table *, char **);
+
+// Recognise a redirection operator
+int redirect_operator(const char *, int *, const char **);
+
+// Add a redirection to a table
+boolean redirect_add(redirection_table *, const int, const int, const char *);
+
+// Open a file for a redirection
+int redirect_open(redirection_table *, const char *, const int);
+
+// Create a file holding a here-document or here-string
+int redirect_here_document(redirection_table *, const char *, const boolean);
+
+// Move a file descriptor opened for a redirection out of the way of the redirected file descriptors
+int redirect_keep(redirection_table *, const int);
+
+// Find the file descriptor of the shell which a file descriptor of the command refers to
+int redirect_target(const redirection_table *, const int);
+
+// Check whether a file descriptor of the command is redirected
+boolean is_redirected(const redirection_table *, const int);
+
+// Remove the redirections of a file descriptor
+void redirect_forget(redirection_table *, const int);
+
+// Apply the redirections to the file descriptors of the shell
+void redirect_apply(const redirection_table *, int *);
+
+// Undo the redirections applied to the file descriptors of the shell
+void redirect_restore(const redirection_table *, const int *);
+
+// Close the files opened for the redirections and empty the table
+void redirect_close(redirection_table *);
+
+// Display an error message that a redirection failed
+void error_redirect(const char *, const char *);
+
+#endif // #ifndef __REDIRECT_H_
@@ -0,0 +1,108 @@
+/*
+ * server.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the shell server, which executes the command lines of
+ * many clients without starting a new shell for each of them, and the client
+ * which passes its command lines to the server.
+ */
+#ifndef __SERVER_H_
+#define __SERVER_H_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "launch.h"
+#include "path_cache.h"
+#include "variables.h"
+#include "utility.h"
+#include "writer.h"
+#include "strings.h"
+
+#define SERVER_MAGIC        0x6d797368 // identifies a request from a client ("mysh")
+#define SERVER_BACKLOG      128 // maximum number of connections waiting to be accepted
+#define SERVER_MAX_EVENTS   64 // maximum number of events handled by each call to epoll_wait
+#define SERVER_MAX_REQUEST  (4 * 1024 * 1024) // maximum length of the strings of a request
+#define SERVER_NUM_FDS      3 // number of file descriptors passed by a client (stdin, stdout and stderr)
+
+typedef struct {
+    uint32_t magic; // SERVER_MAGIC
+    uint32_t num_args; // number of arguments to the shell (not including the name of the shell)
+    uint32_t num_env; // number of environment variables
+    uint32_t length; // length of the strings which follow: the current working directory, the arguments and the environment variables (each null-terminated)
+} server_request;
+
+typedef struct server_client {
+    struct server_client * next; // the next client of the server
+    int fd; // the connection to the client
+    int fds[SERVER_NUM_FDS]; // stdin, stdout and stderr of the client (-1 until they are received)
+    server_request request; // the request of the client
+    size_t header_received; // number of bytes of request which have been received
+    char * strings; // the strings of the request (null until the header has been received)
+    size_t strings_received; // number of bytes of strings which have been received
+    pid_t pid; // the process executing the session of the client (0 until the session starts)
+} server_client;
+
+extern char * path; // path to the executable
+extern char ** environ; // the environment of the shell
+extern boolean replace_last; // may the shell be replaced by the last command it executes?
+
+// Execute the command lines of the shell (see myshell.c)
+int run_shell(int, char **);
+
+// Run the shell server
+int server_run(const char *);
+
+// Create the socket on which the server listens
+int server_listen(const char *);
+
+// Accept the connections waiting on the socket of the server
+void server_accept(void);
+
+// Handle activity on the connection to a client
+void server_client_event(server_client *);
+
+// Receive more of the request of a client
+int server_receive(server_client *);
+
+// Check whether the request of a client is well-formed
+boolean server_request_valid(const server_client *);
+
+// Start a session to execute the command lines of a client
+void server_start_session(server_client *);
+
+// Execute the command lines of a client and report the exit status to the client
+void server_session(server_client *);
+
+// Reap the sessions which have finished
+void server_reap(void);
+
+// Close the connection to a client and forget the client
+void server_close_client(server_client *);
+
+// Pass the command lines of the shell to a shell server
+int client_run(const char *, char **);
+
+// Record a signal received by the client, so that it can be passed to the server
+void client_signal_handler(int);
+
+// Display an error message that the server or client failed
+void error_server(const char *, const char *);
+
+#endif // #ifndef __SERVER_H_
@@ -1,55 +1,113 @@
-/*
- * strings.h
- *
- * Author: Joshua Spence
- * SID:    308216350
- *
- * This file defines strings used in the 'myshell' shell. The shell can be
- * customised by changing strings in this file.
-*/
-#ifndef __STRINGS_H_
-#define __STRINGS_H_
-
-#define PROMPT_SUFFIX               " ==> " // appears at the end of the shell prompt
-#define PAUSE_MESSAGE               "Press Enter to continue..." // prompt to display when in pause command
-
-#define README_PATH                 "./manual" // path to readme file relative to startup path
-
-// Internal commands
-#define CHANGE_DIRECTORY_COMMAND    "cd"
-#define CLEAR_SCREEN_COMMAND        "clr"
-#define LIST_DIRECTORY_COMMAND      "dir"
-#define PRINT_ENVIRONMENT_COMMAND   "environ"
-#define ECHO_COMMAND                "echo"
-#define HELP_COMMAND                "help"
-#define PAUSE_COMMAND               "pause"
-#define QUIT_COMMAND                "quit"
-
-#define CHANGE_DIRECTORY_CMD_NAME   "Change directory"
-#define CLEAR_SCREEN_CMD_NAME       "Clear screen"
-#define LIST_DIRECTORY_CMD_NAME     "List directory"
-#define PRINT_ENVIRONMENT_CMD_NAME  "Print environment"
-#define ECHO_CMD_NAME               "Echo"
-#define HELP_CMD_NAME               "Help"
-#define PAUSE_CMD_NAME              "Pause"
-#define QUIT_CMD_NAME               "Quit"
-
-// Special characters
-#define DONT_WAIT_CHARACTER         '&' // character used to set dont_wait variable to run commands in the background
-#define INPUT_REDIRECTION_CHAR      '<' // character used to redirect input from a file
-#define OUTPUT_REDIRECTION_CHAR     '>' // character used to redict output to a file
-#define SEPARATORS                  " \t\n" // token sparators
-#define QUOTATION_MARKS             "\"" // quotation marks
-#define EXIT_PAUSE_CHARACTER        '\n' // character used to exit pause mode
-
-#ifdef DEBUG
-
-#define DEBUG_COMMAND               "debug" // command to access debug mode
-#define DEBUG_ON                    "on" // command line argument to turn debug mode on
-#define DEBUG_OFF                   "off" // command line argument to turn debug mode off
-
-#define DEBUG_PROMPT				"[DEBUG MODE] " // text to prefix shell prompt if debug mode active
-#define DEBUG_MESSAGE_PREFIX		"[DEBUG]: " // text to appear before any debug messages
-
-#endif // #ifdef DEBUG
-#endif // #ifndef __STRINGS_H_
+/*
+ * strings.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file defines strings used in the 'myshell' shell. The shell can be
+ * customised by changing strings in this file.
+*/
+#ifndef __STRINGS_H_
+#define __STRINGS_H_
+
+#define PROMPT_SUFFIX               " ==> " // appears at the end of the shell prompt
+#define PAUSE_MESSAGE               "Press Enter to continue..." // prompt to display when in pause command
+
+#define README_PATH                 "./manual" // path to readme file relative to startup path
+#define MANUAL_COMMANDS_HEADING     "COMMANDS" // heading of the section of the readme file describing each command
+#define PAGER_PROMPT                "--More--" // prompt to display between each screen of help
+
+// Internal commands
+#define CHANGE_DIRECTORY_COMMAND    "cd"
+#define CLEAR_SCREEN_COMMAND        "clr"
+#define LIST_DIRECTORY_COMMAND      "dir"
+#define PRINT_ENVIRONMENT_COMMAND   "environ"
+#define ECHO_COMMAND                "echo"
+#define HELP_COMMAND                "help"
+#define HASH_COMMAND                "hash"
+#define PAUSE_COMMAND               "pause"
+#define QUIT_COMMAND                "quit"
+#define EXEC_COMMAND                "exec"
+#define JOBS_COMMAND                "jobs"
+#define WAIT_COMMAND                "wait"
+#define FOREGROUND_COMMAND          "fg"
+#define BACKGROUND_COMMAND          "bg"
+#define EXPORT_COMMAND              "export"
+#define UNSET_COMMAND               "unset"
+
+#define CHANGE_DIRECTORY_CMD_NAME   "Change directory"
+#define CLEAR_SCREEN_CMD_NAME       "Clear screen"
+#define LIST_DIRECTORY_CMD_NAME     "List directory"
+#define PRINT_ENVIRONMENT_CMD_NAME  "Print environment"
+#define ECHO_CMD_NAME               "Echo"
+#define HELP_CMD_NAME               "Help"
+#define HASH_CMD_NAME               "Hash"
+#define PAUSE_CMD_NAME              "Pause"
+#define QUIT_CMD_NAME               "Quit"
+#define EXEC_CMD_NAME               "Exec"
+#define JOBS_CMD_NAME               "Jobs"
+#define WAIT_CMD_NAME               "Wait"
+#define FOREGROUND_CMD_NAME         "Foreground"
+#define BACKGROUND_CMD_NAME         "Background"
+#define EXPORT_CMD_NAME             "Export"
+#define UNSET_CMD_NAME              "Unset"
+
+// Special characters
+#define DONT_WAIT_CHARACTER         '&' // character used to set dont_wait variable to run commands in the background
+#define INPUT_REDIRECTION_CHAR      '<' // character used to redirect input from a file
+#define OUTPUT_REDIRECTION_CHAR     '>' // character used to redict output to a file
+#define REDIRECTION_FD_CHAR         '&' // character after a redirection character which redirects to another file descriptor (or before it to redirect stdout and stderr)
+#define REDIRECTION_CLOSE_CHAR      '-' // file descriptor after REDIRECTION_FD_CHAR which closes the redirected file descriptor
+#define HERE_DOCUMENT_OPERATOR      "<<" // redirects input from the following lines of the input, up to a delimiter
+#define HERE_STRING_OPERATOR        "<<<" // redirects input from the following argument
+#define HERE_DOCUMENT_NAME          "here-document" // name of the memory file holding a here-document or here-string
+#define PIPE_CHARACTER              '|' // character used to connect the output of one command to the input of the next
+#define SEQUENCE_OPERATOR           ";" // separates commands which are executed one after the other
+#define AND_OPERATOR                "&&" // the next command is only executed if the previous command succeeded
+#define OR_OPERATOR                 "||" // the next command is only executed if the previous command failed
+#define JOB_CHARACTER               '%' // character used to refer to a job by its job number
+#define EXPANSION_CHARACTER         '$' // character used to expand a variable
+#define EXPANSION_OPEN              '{' // character which may start a variable name after EXPANSION_CHARACTER
+#define EXPANSION_CLOSE             '}' // character which ends a variable name started by EXPANSION_OPEN
+#define STATUS_VARIABLE             '?' // variable name which expands to the exit status of the last command
+#define SUBSTITUTION_OPEN           '(' // character after EXPANSION_CHARACTER which starts a command substitution
+#define SUBSTITUTION_CLOSE          ')' // character which ends a command substitution
+#define ASSIGNMENT_CHARACTER        '=' // character which separates the name and value of a variable assignment
+#define GLOB_CHARACTERS             "*?[" // characters which make an argument a pathname pattern (unless quoted)
+#define GLOB_ANY_STRING             '*' // matches any string in a pathname pattern
+#define GLOB_ANY_CHARACTER          '?' // matches any single character in a pathname pattern
+#define GLOB_SET_OPEN               '[' // starts a set of characters in a pathname pattern
+#define GLOB_SET_CLOSE              ']' // ends a set of characters in a pathname pattern
+#define GLOB_SET_NEGATE             '!' // negates a set of characters in a pathname pattern
+#define GLOB_SET_RANGE              '-' // separates the ends of a range of characters in a pathname pattern
+#define GLOB_ESCAPE                 '\\' // makes the next character of a pathname pattern an ordinary character
+#define SEPARATORS                  " \t\n" // token sparators
+#define OPERATORS                   ";" // characters which form an argument of their own, even without separators
+#define QUOTATION_MARKS             "\"" // quotation marks
+#define EXIT_PAUSE_CHARACTER        '\n' // character used to exit pause mode
+#define PAGER_LINE_CHARACTER        '\n' // character used to display one more line of help
+#define PAGER_QUIT_CHARACTER        'q' // character used to stop displaying help
+
+// Command line options
+#define COMMAND_OPTION              "-c" // option to execute a command line given as an argument
+#define STDIN_BATCH_FILE            "-" // batch file name which refers to stdin
+#define PARALLEL_OPTION             "-j" // option to execute the command lines of a batch file in parallel
+#define KEEP_GOING_OPTION           "--keep-going" // option to continue executing a parallel batch after a command line fails
+#define SERVE_OPTION                "--serve" // option to run a shell server listening on a socket
+#define CLIENT_OPTION               "--client" // option to pass the command lines to a shell server listening on a socket
+#define ZYGOTE_OPTION               "--zygote" // option to launch external programs from a fork server started with the shell
+
+#define HASH_RESET                  "-r" // argument to the hash command to forget all remembered paths
+
+#ifdef DEBUG
+
+#define DEBUG_COMMAND               "debug" // command to access debug mode
+#define DEBUG_CMD_NAME              "Debug"
+#define DEBUG_ON                    "on" // command line argument to turn debug mode on
+#define DEBUG_OFF                   "off" // command line argument to turn debug mode off
+
+#define DEBUG_PROMPT				"[DEBUG MODE] " // text to prefix shell prompt if debug mode active
+#define DEBUG_MESSAGE_PREFIX		"[DEBUG]: " // text to appear before any debug messages
+
+#endif // #ifdef DEBUG
+#endif // #ifndef __STRINGS_H_
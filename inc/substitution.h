@@ -0,0 +1,66 @@
+/*
+ * substitution.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains command substitution, which replaces a command in the
+ * arguments of a command line by the output of the command.
+ */
+#ifndef __SUBSTITUTION_H_
+#define __SUBSTITUTION_H_
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "jobs.h"
+#include "launch.h"
+#include "reader.h"
+#include "redirect.h"
+#include "utility.h"
+#include "strings.h"
+
+#define SUBSTITUTION_READ_SIZE  65536 // initial size of the buffer into which the output of a command is read
+
+typedef struct command_output {
+    char * output; // the output of the command
+    size_t length; // length of the output
+    struct command_output * next; // the output of the next command substitution of the argument
+} command_output;
+
+typedef struct {
+    int fd; // the read end of the pipe to which the command writes
+    arena memory; // memory for the buffer
+    char * buffer; // the output which has been read
+    size_t length; // number of bytes of buffer which are used
+    size_t capacity; // number of bytes allocated for buffer
+} substitution_capture;
+
+extern process_information proc_info; // information about child processes
+extern const char * command_line; // the command line being executed (NOT null-terminated)
+extern size_t command_line_length; // length of the command line being executed
+extern boolean last_line; // is the command line being executed the last of the input?
+extern int last_status; // exit status of the last command executed
+#ifdef DEBUG
+extern boolean debug; // is debug mode active?
+#endif // #ifdef DEBUG
+
+// Execute the arguments of a command line (see myshell.c)
+int execute_line(char **);
+
+// Check whether a command line uses an internal command which changes the state of the shell (see myshell.c)
+boolean is_barrier_line(char **);
+
+// Execute a command and capture its output
+char * command_substitution(arena *, const char *, const size_t, size_t *);
+
+// Read the output of a command substitution until the command closes it
+void * substitution_thread(void *);
+
+#endif // #ifndef __SUBSTITUTION_H_
@@ -0,0 +1,99 @@
+/*
+ * variables.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the variables of the shell, which include the environment
+ * variables (the exported variables), and the expansion of variables and
+ * command substitutions in the arguments of a command line.
+ */
+#ifndef __VARIABLES_H_
+#define __VARIABLES_H_
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "lexer.h"
+#include "substitution.h"
+#include "utility.h"
+#include "writer.h"
+#include "strings.h"
+
+#define VARIABLE_INDEX_SIZE 64 // initial number of slots in the hash index (must be a power of two)
+#define VARIABLE_EMPTY      -1 // hash index slot which has never been used
+#define VARIABLE_REMOVED    -2 // hash index slot of a variable which has been unset
+
+typedef struct {
+    char * string; // the variable as "name=value" (null if the variable has been unset)
+    size_t name_length; // length of the name of the variable
+    boolean exported; // is the variable in the environment of child processes?
+} variable;
+
+typedef struct {
+    char * output; // next character of the expanded argument (null while measuring)
+    size_t length; // length of the expanded argument (including the characters between fields)
+    char flags; // the flags of each field
+    unsigned int num_fields; // number of fields which have been started
+    boolean in_field; // is a field being written (rather than separators between fields)?
+} token_writer;
+
+extern int last_status; // exit status of the last command executed
+extern unsigned long variables_generation; // incremented whenever the exported variables change
+extern char ** environ; // pointer to environment variables
+#ifdef DEBUG
+extern boolean debug; // is debug mode active?
+#endif // #ifdef DEBUG
+
+// Import the environment variables of the shell
+void variables_setup(void);
+
+// Free the memory used by the variables
+void variables_free(void);
+
+// Calculate the hash of a variable name
+unsigned int variable_hash(const char *, const size_t);
+
+// Find the hash index slot of a variable
+int * variable_slot(const char *, const size_t);
+
+// Get the value of a variable
+const char * variable_get(const char *, const size_t);
+
+// Set the value of a variable
+void variable_set(const char *, const size_t, const char *, const boolean);
+
+// Mark a variable to be exported to child processes
+void variable_export(const char *, const size_t);
+
+// Remove a variable
+void variable_unset(const char *, const size_t);
+
+// Rebuild the hash index
+void variables_rehash(const unsigned int);
+
+// Build an environment from the exported variables
+char ** variables_environment(char *);
+
+// Print the exported variables
+void variables_print(writer *);
+
+// Find the length of the variable name at the start of a string
+size_t variable_name_length(const char *);
+
+// Check whether an argument is a variable assignment
+boolean is_assignment(const char *);
+
+// Expand the variables and command substitutions in an argument
+char * expand_token(arena *, const char *, unsigned int *);
+
+// Write part of an expanded argument
+void token_write(token_writer *, const char *, const size_t, const boolean, const boolean);
+
+// Expand the variables and command substitutions in the arguments of a command
+char ** expand_arguments(arena *, char **);
+
+#endif // #ifndef __VARIABLES_H_
@@ -0,0 +1,47 @@
+/*
+ * writer.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the buffered output of the shell, through which internal
+ * commands write to stdout.
+ */
+#ifndef __WRITER_H_
+#define __WRITER_H_
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#define WRITER_BUFFER_SIZE  65536 // size of the output buffer
+
+typedef struct {
+    int fd; // file descriptor to which output is written
+    size_t used; // number of bytes in data
+    char data[WRITER_BUFFER_SIZE]; // buffered output
+} writer;
+
+extern writer shell_output; // the output of the shell (stdout)
+
+// Add bytes to the output of a writer
+int writer_write(writer *, const char *, const size_t);
+
+// Add a string to the output of a writer
+int writer_puts(writer *, const char *);
+
+// Add formatted output to the output of a writer
+int writer_printf(writer *, const char *, ...);
+
+// Write the buffered output of a writer (and any further bytes) to its file descriptor
+int writer_flush_with(writer *, const char *, const size_t);
+
+// Write the buffered output of a writer to its file descriptor
+int writer_flush(writer *);
+
+#endif // #ifndef __WRITER_H_
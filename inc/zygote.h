@@ -0,0 +1,90 @@
+/*
+ * zygote.h
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the fork server, a small helper process which launches
+ * external programs on behalf of the shell.
+ */
+#ifndef __ZYGOTE_H_
+#define __ZYGOTE_H_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include "jobs.h"
+#include "redirect.h"
+#include "variables.h"
+#include "utility.h"
+#include "strings.h"
+
+#define ZYGOTE_STACK_SIZE   65536 // size of the stack on which a program is launched
+#define ZYGOTE_MAX_FDS      (REDIRECT_MAX_FD + 1 + 2 + REDIRECT_MAX) // maximum number of file descriptors passed with a request
+#define ZYGOTE_EXEC_FAILED  127 // exit status of a child process which could not execute its program
+
+typedef struct {
+    uint32_t num_args; // number of arguments (including the name of the program)
+    uint32_t num_env; // number of environment strings
+    uint32_t length; // length of the strings which follow: the path to the program, the arguments and (if new_environment) the environment strings (each null-terminated)
+    boolean new_environment; // has the environment changed since the last request?
+    pid_t pgid; // process group for the program (see launch_program)
+    boolean foreground; // will the shell wait for the program?
+    boolean job_control; // is the shell performing job control?
+    uint32_t open_fds; // bit n is set if file descriptor n (at most REDIRECT_MAX_FD) of the shell is open
+    uint32_t cloexec_fds; // bit n is set if file descriptor n of the shell is closed on exec
+    int input_index; // index of the file descriptor to be used as stdin (-1 if none)
+    int output_index; // index of the file descriptor to be used as stdout (-1 if none)
+    uint32_t num_fds; // number of file descriptors passed with the request
+    uint32_t num_redirects; // number of entries of redirects which are used
+    redirection redirects[REDIRECT_MAX]; // the redirections of the command (see redirects)
+    int source_index[REDIRECT_MAX]; // index of the file descriptor passed for the source of each redirection (-1 if the source is not an opened file)
+} zygote_request;
+
+typedef struct {
+    pid_t pid; // process ID of the child process (-1 on failure)
+    int error; // error number on failure
+} zygote_reply;
+
+typedef struct {
+    const zygote_request * request; // the request
+    const int * fds; // the file descriptors passed with the request
+    const char * file; // the full path to the program
+    char ** args; // the arguments of the program
+    char ** envp; // the environment of the program
+} zygote_launch_information;
+
+// Start the fork server
+void zygote_start(void);
+
+// Stop the fork server
+void zygote_stop(void);
+
+// Check whether programs may be launched by the fork server
+boolean zygote_running(void);
+
+// Launch a program in a child process by the fork server
+boolean zygote_launch(const char *, char **, char **, const int, const int, const pid_t, pid_t *);
+
+// Handle the requests of the shell (in the fork server)
+void zygote_serve(const int);
+
+// Receive bytes (and file descriptors) from the shell (in the fork server)
+boolean zygote_receive(const int, void *, size_t, int *, unsigned int *);
+
+// Prepare a child process of the fork server and execute its program
+int zygote_child(void *);
+
+// Display an error message that the fork server could not be started
+void error_zygote(const char *);
+
+#endif // #ifndef __ZYGOTE_H_
@@ -0,0 +1,138 @@
+/*
+ * arena.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains a bump allocator for memory which is only required while
+ * a single command line is processed.
+ *
+ * Memory is allocated by advancing a pointer through a block, and is never
+ * freed individually. Instead, the whole arena is reset once the command line
+ * has been processed. If a command line needed more than one block, the
+ * blocks are replaced by a single block large enough for all of them when the
+ * arena is reset, so that a similar command line can then be processed
+ * without allocating any memory from the heap.
+ */
+
+#include "../inc/arena.h"
+#include "../inc/utility.h"
+
+/*
+ * Prepare an arena for use. No memory is allocated until the first call to
+ * arena_alloc.
+ *
+ * PARAMETERS
+ *     a: The arena to prepare.
+ */
+void arena_init(arena * a) {
+    a->block = NULL;
+    a->allocations = 0;
+    a->bytes = 0;
+    a->heap_allocations = 0;
+    a->total_heap_allocations = 0;
+}
+
+/*
+ * Allocate memory from an arena. The memory remains valid until the arena is
+ * reset, and must not be freed by the caller.
+ *
+ * PARAMETERS
+ *     a: The arena from which memory should be allocated.
+ *     size: The number of bytes to allocate.
+ *
+ * RETURN VALUE
+ * A pointer to the allocated memory, aligned to ARENA_ALIGNMENT bytes.
+ */
+void * arena_alloc(arena * a, const size_t size) {
+    arena_block * block = a->block; // the current block
+    size_t offset = 0; // offset of the allocation within the block
+
+    if (block) {
+        // Align the allocation
+        offset = block->used + ((ARENA_ALIGNMENT - (((uintptr_t) (block->data + block->used)) & (ARENA_ALIGNMENT - 1))) & (ARENA_ALIGNMENT - 1));
+    }
+
+    if (!block || (offset + size > block->size)) {
+        // Memory allocation
+        block = arena_new_block(a, (block ? block->size * 2 : ARENA_BLOCK_SIZE) + size);
+        offset = (ARENA_ALIGNMENT - (((uintptr_t) block->data) & (ARENA_ALIGNMENT - 1))) & (ARENA_ALIGNMENT - 1);
+    }
+
+    block->used = offset + size;
+    a->allocations++;
+    a->bytes += size;
+
+    return block->data + offset;
+}
+
+/*
+ * Release all memory allocated from an arena. If more than one block was
+ * needed since the arena was last reset, the blocks are replaced by a single
+ * block as large as all of them together.
+ *
+ * PARAMETERS
+ *     a: The arena to reset.
+ */
+void arena_reset(arena * a) {
+    size_t size = 0; // total size of the blocks
+
+    if (a->block && a->block->next) {
+        for (arena_block * block = a->block; block; block = block->next) {
+            size += block->size;
+        }
+
+        arena_free(a);
+        arena_new_block(a, size);
+    } else if (a->block) {
+        a->block->used = 0;
+    }
+
+    a->allocations = 0;
+    a->bytes = 0;
+    a->heap_allocations = 0;
+}
+
+/*
+ * Free all of the blocks of an arena. The arena may be used again afterwards.
+ *
+ * PARAMETERS
+ *     a: The arena to free.
+ */
+void arena_free(arena * a) {
+    arena_block * next; // the block after the current block
+
+    while (a->block) {
+        next = a->block->next;
+        free(a->block);
+        a->block = next;
+    }
+}
+
+/*
+ * Allocate a new block for an arena from the heap. The new block becomes the
+ * block from which memory is allocated.
+ *
+ * PARAMETERS
+ *     a: The arena to which the block should be added.
+ *     size: The number of bytes of data in the block (including any bytes
+ *         required for alignment).
+ *
+ * RETURN VALUE
+ * A pointer to the new block.
+ */
+arena_block * arena_new_block(arena * a, const size_t size) {
+    arena_block * block; // the new block
+
+    // Memory allocation
+    if (!(block = (arena_block *) malloc(sizeof(arena_block) + size + ARENA_ALIGNMENT))) sys_err("malloc"); // attempt to allocate memory for block
+
+    block->next = a->block;
+    block->size = size + ARENA_ALIGNMENT;
+    block->used = 0;
+    a->block = block;
+    a->heap_allocations++;
+    a->total_heap_allocations++;
+
+    return block;
+}
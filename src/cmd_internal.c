@@ -1,600 +1,699 @@
-/*
- * cmd_intenal.c
- *
- * Author:     Joshua Spence
- * SID:        308216350
- *
- * This file contains the internal shell functions.
- */
-
-#include "../inc/cmd_internal.h"
-
-/*
- * Change the current working directory to the specified directory.
- *
- * PARAMETERS
- *     directory: The directory to change to. If null, then the current working
- *         directory is output.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int change_directory(const char * directory) {
-    char * cwd; // current working directory
-    int stdout_save; // to save and restore stdout
-
-    if (proc_info.dont_wait) {
-        err("Background execution is not supported for this command. Ignoring this parameter.");
-    }
-
-    if (input_redir) {
-        err("Input redirection is not supported for this command. Ignoring this parameter.");
-    }
-
-    if (directory == NULL) {
-        // Directory not specified - report current directory
-#ifdef DEBUG
-        if (debug) {
-            debug_message("Directory not specified. Reporting current directory.");
-        }
-
-#endif // #ifdef DEBUG
-        // Get the current working directory
-        cwd = getcwd(NULL, (size_t) 0); // getcwd will dynamically allocate memory for cwd
-
-        // Redirect output if necessary
-        if (output_redir != NULL) {
-            stdout_save = dup(STDOUT_FILENO); // save stdout
-            dup2(fileno(output_redir), STDOUT_FILENO); // redirect output
-        }
-
-        // Output the current working directory
-        printf("%s\n", cwd);
-
-        if (output_redir != NULL) {
-            dup2(stdout_save, STDOUT_FILENO); // restore stdout
-        }
-
-        // Clean up
-        free(cwd); // free the memory dynamically allocated by getcwd
-    } else {
-        // Directory specified - change to this directory
-#ifdef DEBUG
-        if (debug) {
-            // Create debug message
-            const char msg[] = "Directory '%s' specified. Attempt to change to this directory.";
-            char * dbg_msg;
-
-            // Memory allocation
-            if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(directory) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-            // Output debug message
-            sprintf(dbg_msg, msg, directory);
-            debug_message(dbg_msg);
-
-            // Clean up
-            free(dbg_msg);
-        }
-
-#endif // #ifdef DEBUG
-        // Attempt to change the directory
-        if (!chdir(directory)) {
-#ifdef DEBUG
-            if (debug) {
-                // Create debug message
-                const char msg[] = "Changed current working directory to '%s'.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(directory) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, msg, directory);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            // Get the full path to the new directory
-            cwd = getcwd(NULL, (size_t) 0); // getcwd will dynamically allocate memory for cwd
-
-#ifdef DEBUG
-            if (debug) {
-                debug_message("Attempting to change 'PWD' environment variable.");
-            }
-#endif // #ifdef DEBUG
-            // Set the environment variable to the new directory
-            if (setenv("PWD", cwd, 1)) sys_err("setenv"); // set the 'pwd' environment variable to the new directory, overwriting any existing value
-
-#ifdef DEBUG
-            if (debug) {
-                // Create debug message
-                const char dbg[] = "Changed 'PWD' environment variable '%s'.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(dbg) + strlen(cwd) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, dbg, cwd);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            // Clean up
-            free(cwd); // free the memory dynamically allocated by getcwd
-        } else {
-            // Unable to change directory - output error message
-            // Create error message
-            const char msg[] = "Unable to change to directory '%s'.";
-            char * err_msg;
-
-            // Memory allocation
-            if (!(err_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(directory) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); /* attempt to allocate memory for err_msg */
-
-            // Output error message
-            sprintf(err_msg, msg, directory);
-            err(err_msg);
-
-            // Clean up
-            free(err_msg);
-        }
-    }
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * Clear the terminal screen.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int clear_screen(void) {
-    if (proc_info.dont_wait) {
-        err("Background execution is not supported for this command. Ignoring this parameter.");
-    }
-    if (input_redir) {
-        err("Input redirection is not supported for this command. Ignoring this parameter.");
-    }
-    if (output_redir) {
-        err("Output redirection is not supported for this command. Ignoring this parameter.");
-    }
-
-    // Clear the screen
-    system("clear");
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * List the contents of a directory.
- *
- * PARAMETERS
- *     directory: The path of the directory to list the contents of.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int list_directory(const char * directory) {
-    // Fork the current process
-    switch (proc_info.pid = fork()) {
-        case -1: // fork failed
-            sys_err("fork");
-            break;
-
-        case 0: // child
-#ifdef DEBUG
-            if (debug) {
-                debug_message("Setting 'parent' environment variable in child process.");
-            }
-
-#endif // #ifdef DEBUG
-            // Set environment variable
-            if (setenv("parent", path, 1)) sys_err("setenv"); // set the 'parent' environment variable to the path to the shell, overwriting any existing value
-
-#ifdef DEBUG
-            if (debug) {
-                debug_message("Executing '/bin/ls' in child process.");
-            }
-
-#endif
-            // Redirect input if necessary
-            if (input_redir) {
-                    dup2(fileno(input_redir), STDIN_FILENO);
-            }
-
-            // Redirect output if necessary
-            if (output_redir) {
-                    dup2(fileno(output_redir), STDOUT_FILENO);
-            }
-
-            // Execute the command with the appropriate arguments
-            execlp("/bin/ls", "ls", "-al", directory, NULL);
-            sys_err("execlp"); // if execution reaches this line, an error has occured as execlp should never return
-            break;
-
-        default: // parent
-            if (!proc_info.dont_wait) {
-#ifdef DEBUG
-                if (debug) {
-                    // Create debug message
-                    const char dbg[] = "Parent process waiting for child process [PID: %d] to return.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((strlen(dbg) + digits(proc_info.pid) + 1) * sizeof(char)))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, dbg, proc_info.pid);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                // Wait for the child process to return
-                waitpid(proc_info.pid, &proc_info.status, WUNTRACED);
-#ifdef DEBUG
-
-                if (debug) {
-                    // Create debug message
-                    const char dbg[] = "Child process %d has returned with status: %d.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((strlen(dbg) + digits(proc_info.pid) + digits(proc_info.status) + 1) * sizeof(char)))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, dbg, proc_info.pid, proc_info.status);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-#endif // #ifdef DEBUG
-            }
-#ifdef DEBUG
-            else {
-                if (debug) {
-                    // Create debug message
-                    const char dbg[] = "Parent process continuing without waiting for child process [PID: %d] to return.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((strlen(dbg) + digits(proc_info.pid) + 1) * sizeof(char)))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, dbg, proc_info.pid);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-            }
-
-#endif // #ifdef DEBUG
-    }
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * Print the environment variables.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int print_environment(void) {
-    const char ** env = (const char **) environ; // pointer to step through environment variables
-    int stdout_save; // to save and restore stdout
-
-    if (proc_info.dont_wait) {
-        err("Background execution is not supported for this command. Ignoring this parameter.");
-    }
-    if (input_redir) {
-        err("Input redirection is not supported for this command. Ignoring this parameter.");
-    }
-
-    // Redirect output if necessary
-    if (output_redir) {
-        stdout_save = dup(STDOUT_FILENO); // save stdout
-        dup2(fileno(output_redir), STDOUT_FILENO); // redirect output
-    }
-
-    // Print all environment variables
-    while(*env) {
-        printf("%s\n", *env++);
-    }
-
-    if (output_redir) {
-        dup2(stdout_save, STDOUT_FILENO); // restore stdout
-    }
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * Echo a comment to the terminal.
- *
- * PARAMETERS
- *     args: The first argument that forms the comment to be echoed.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int echo(const char ** args) {
-    int stdin_save; // to save and restore stdin
-    int stdout_save; // to save and restore stdout
-
-    if (proc_info.dont_wait) {
-        err("Background execution is not supported for this command. Ignoring this parameter.");
-    }
-
-    // Redirect input if necessary
-    if (input_redir) {
-        stdin_save = dup(STDIN_FILENO); // save stdin
-        dup2(fileno(input_redir), STDIN_FILENO); // redirect input
-    }
-
-    // Redirect output if necessary
-    if (output_redir) {
-        stdout_save = dup(STDOUT_FILENO); // save stdout
-        dup2(fileno(output_redir), STDOUT_FILENO); // redirect output
-    }
-
-    // Print the comments
-    while(*args) {
-        printf("%s ", *args++);
-    }
-    printf("\n");
-
-    if (input_redir) {
-        dup2(stdin_save, STDIN_FILENO); // restore stdin
-    }
-    if (output_redir) {
-        dup2(stdout_save, STDOUT_FILENO); // restore stdout
-    }
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * Get help.
- *
- * PARAMETERS
- *     home: The path to the home directory, which should contain the readme
- *         file.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int help(const char * home) {
-    // Fork the current process
-    switch(proc_info.pid = fork()) {
-        case -1: // fork failed
-            sys_err("fork");
-            break;
-
-        case 0: // child
-#ifdef DEBUG
-            if (debug) {
-                debug_message("Setting 'parent' environment variable in child process.");
-            }
-
-#endif // #ifdef DEBUG
-            // Set environment variable
-            if (setenv("parent", path, 1)) sys_err("setenv"); // set the 'parent' environment variable to the path to the shell, overwriting any existing value
-
-#ifdef DEBUG
-            if (debug) {
-                debug_message("Executing '/bin/more' in child process.");
-            }
-
-#endif // #ifdef DEBUG
-            // Redirect input if necessary
-            if (input_redir) {
-                dup2(fileno(input_redir), STDIN_FILENO);
-            }
-
-            // Redirect output if necessary
-            if (output_redir) {
-                dup2(fileno(output_redir), STDOUT_FILENO);
-            }
-
-            // Change to the directory in which the readme file should exist
-            if (chdir(home)) sys_err("chdir"); // attempt to change to home directory
-
-            // Ensure readme file exists and can be read
-            if (!access(README_PATH, R_OK)) {
-                // Create error message
-                const char msg[] = "Unable to open the readme file '%s'.";
-                char * err_msg;
-
-                // Memory allocation
-                if (!(err_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(README_PATH) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output error message
-                sprintf(err_msg, msg, README_PATH);
-                err(err_msg);
-
-                // Clean up
-                free(err_msg);
-            }
-
-            // Execute the command with the appropriate arguments
-            execlp("/bin/more", "more", README_PATH, NULL);
-            sys_err("execlp"); // if execution reaches this line, an error has occured as execlp should never return
-            break;
-
-        default: // parent
-            if (!proc_info.dont_wait) {
-#ifdef DEBUG
-                if (debug) {
-                    // Create debug message
-                    const char dbg[] = "Parent process waiting for child process [PID: %d] to return.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((strlen(dbg) + digits(proc_info.pid) + 1) * sizeof(char)))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, dbg, proc_info.pid);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                // Wait for the child process to return
-                waitpid(proc_info.pid, &proc_info.status, WUNTRACED);
-#ifdef DEBUG
-
-                if (debug) {
-                    // Create debug message
-                    const char dbg[] = "Child process %d has returned with status: %d.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if(!(dbg_msg = (char *) malloc((strlen(dbg) + digits(proc_info.pid) + digits(proc_info.status) + 1) * sizeof(char)))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, dbg, proc_info.pid, proc_info.status);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-#endif // #ifdef DEBUG
-            }
-#ifdef DEBUG
-            else {
-                if (debug) {
-                    // Create debug message
-                    const char dbg[] = "Parent process continuing without waiting for child process [PID: %d] to return.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((strlen(dbg) + digits(proc_info.pid) + 1) * sizeof(char)))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, dbg, proc_info.pid);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-            }
-#endif // #ifdef DEBUG
-    }
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * Pause the shell until a specified key is pressed. Terminal echo will be
- * turned off and a specified prompt will be displayed.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int pause(void) {
-    struct termios old; // structure containing old terminal information
-    struct termios new; // structure containing new terminal information
-    FILE * tty; // pointer to the tty input device
-    char current_character; // the last key pressed
-
-    if (proc_info.dont_wait) {
-        err("Background execution is not supported for this command. Ignoring this parameter.");
-    }
-    if (input_redir) {
-        err("Input redirection is not supported for this command. Ignoring this parameter.");
-    }
-    if (output_redir) {
-        err("Output redirection is not supported for this command. Ignoring this parameter.");
-    }
-
-    // Output pause message
-    printf("%s", PAUSE_MESSAGE);
-
-    if (!(tty = fopen(ctermid(NULL), "r"))) sys_err("fopen"); // attempt to open tty device
-    setbuf(tty, NULL); // set the standard input stream unbuffered
-
-    if (tcgetattr(fileno(tty), &old)) sys_err("tcgetattr"); // attempt to save tty state
-    new = old; // copy the structure
-
-    /*
-     * Disables (note the tilde) the following:
-     *   - ECHO     Echo input characters
-     *   - ECHOE    Echo erase characters as backspace-space-backspace
-     *   - ECHOK    Echo a newline after a kill character
-     *   - ECHONL   Echo newline even if not echoing other characters
-     *   - ICANON   Enable erase, kill, werase, and rprnt special characters
-     */
-    new.c_lflag &= ~(ECHO | ECHOE | ECHOK | ECHONL | ICANON);
-
-    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &new)) sys_err("tcsetattr"); // change to the new terminal state
-
-    // Pause until the specified key is pressed
-    while ((current_character = getc(tty)) != EXIT_PAUSE_CHARACTER);
-
-    if (tcsetattr(fileno(tty), TCSAFLUSH, &old)) sys_err("tcsetattr"); // attempt to restore TTY state
-    printf("\n");
-
-#ifdef DEBUG
-    if (debug) {
-        // Create debug message
-        const char dbg[] = "Escape character '%c' detected. Resuming shell.";
-        char * dbg_msg;
-
-        // Memory allocation
-        if (!(dbg_msg = (char *) malloc((strlen(dbg) + 1 + 1) * sizeof(char)))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-        // Output debug message
-        sprintf(dbg_msg, dbg, EXIT_PAUSE_CHARACTER);
-        debug_message(dbg_msg);
-
-        // Clean up
-        free(dbg_msg);
-    }
-
-#endif // #ifdef DEBUG
-    if (fclose(tty)) sys_err("fclose"); // attempt to close /dev/tty
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * Quit the shell.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int quit(void) {
-    if (proc_info.dont_wait) {
-        err("Background execution is not supported for this command. Ignoring this parameter.");
-    }
-    if (input_redir) {
-        err("Input redirection is not supported for this command. Ignoring this parameter.");
-    }
-    if (output_redir) {
-        err("Output redirection is not supported for this command. Ignoring this parameter.");
-    }
-
-    // Return an exit status indicating to the shell that it should quit
-    return EXIT_STATUS_QUIT;
-}
+/*
+ * cmd_intenal.c
+ *
+ * Author:     Joshua Spence
+ * SID:        308216350
+ *
+ * This file contains the internal shell functions.
+ */
+
+#include "../inc/cmd_internal.h"
+
+/*
+ * Change the current working directory to the specified directory.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command. The first argument is the directory
+ *         to change to. If there are no arguments, then the current working
+ *         directory is output.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int change_directory(char ** args, writer * out) {
+    const char * directory = *args; // the directory to change to
+    char * cwd; // current working directory
+
+    if (directory == NULL) {
+        // Directory not specified - report current directory
+#ifdef DEBUG
+        if (debug) {
+            debug_message("Directory not specified. Reporting current directory.");
+        }
+
+#endif // #ifdef DEBUG
+        // Get the current working directory
+        cwd = getcwd(NULL, (size_t) 0); // getcwd will dynamically allocate memory for cwd
+
+        // Output the current working directory
+        writer_puts(out, cwd);
+        writer_write(out, "\n", 1);
+
+        // Clean up
+        free(cwd); // free the memory dynamically allocated by getcwd
+    } else {
+        // Directory specified - change to this directory
+#ifdef DEBUG
+        if (debug) {
+            // Create debug message
+            const char msg[] = "Directory '%s' specified. Attempt to change to this directory.";
+            char * dbg_msg;
+
+            // Memory allocation
+            dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(directory) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+            // Output debug message
+            sprintf(dbg_msg, msg, directory);
+            debug_message(dbg_msg);
+        }
+
+#endif // #ifdef DEBUG
+        // Attempt to change the directory
+        if (!chdir(directory)) {
+#ifdef DEBUG
+            if (debug) {
+                // Create debug message
+                const char msg[] = "Changed current working directory to '%s'.";
+                char * dbg_msg;
+
+                // Memory allocation
+                dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(directory) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+                // Output debug message
+                sprintf(dbg_msg, msg, directory);
+                debug_message(dbg_msg);
+            }
+
+#endif // #ifdef DEBUG
+            // Get the full path to the new directory
+            cwd = getcwd(NULL, (size_t) 0); // getcwd will dynamically allocate memory for cwd
+
+#ifdef DEBUG
+            if (debug) {
+                debug_message("Attempting to change 'PWD' environment variable.");
+            }
+#endif // #ifdef DEBUG
+            // Set the environment variable to the new directory
+            variable_set("PWD", strlen("PWD"), cwd, TRUE); // set the 'pwd' environment variable to the new directory, overwriting any existing value
+
+#ifdef DEBUG
+            if (debug) {
+                // Create debug message
+                const char dbg[] = "Changed 'PWD' environment variable '%s'.";
+                char * dbg_msg;
+
+                // Memory allocation
+                dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(dbg) + strlen(cwd) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+                // Output debug message
+                sprintf(dbg_msg, dbg, cwd);
+                debug_message(dbg_msg);
+            }
+
+#endif // #ifdef DEBUG
+            // Clean up
+            free(cwd); // free the memory dynamically allocated by getcwd
+        } else {
+            // Unable to change directory - output error message
+            // Create error message
+            const char msg[] = "Unable to change to directory '%s'.";
+            char * err_msg;
+
+            // Memory allocation
+            err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(directory) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+            // Output error message
+            sprintf(err_msg, msg, directory);
+            err(err_msg);
+            proc_info.status = JOB_FAILURE_STATUS;
+        }
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Clear the terminal screen.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command (unused).
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int clear_screen(char ** args, writer * out) {
+    (void) args; // the command has no arguments
+
+    // Clear the screen (after the output so far)
+    writer_flush(out);
+    system("clear");
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * List the contents of a directory. The listing is produced by the shell
+ * itself, without executing another program.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command. The first argument is the path of
+ *         the directory to list the contents of.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int list_directory(char ** args, writer * out) {
+    const char * directory = *args; // the directory to list
+
+    if (write_directory_listing(directory, out)) {
+        error_list_directory(directory);
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Display an error message that a directory could not be listed. Uses the
+ * error number of the last experienced error to generate an error message.
+ *
+ * PARAMETERS
+ *     directory: The path of the directory that could not be listed.
+ */
+void error_list_directory(const char * directory) {
+    // Create error message
+    const char msg[] = "Unable to list the directory '%s': %s.";
+    const char * reason = strerror(errno); // the reason for the failure
+    char * err_msg;
+
+    if (!directory) {
+        directory = ".";
+    }
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(directory) + strlen(reason) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, directory, reason);
+    err(err_msg);
+    proc_info.status = JOB_FAILURE_STATUS;
+}
+
+/*
+ * Print the environment variables (the exported variables of the shell).
+ *
+ * PARAMETERS
+ *     args: The arguments to the command (unused).
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int print_environment(char ** args, writer * out) {
+    (void) args; // the command has no arguments
+
+    // Print all environment variables
+    variables_print(out);
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Echo a comment to the terminal.
+ *
+ * PARAMETERS
+ *     args: The first argument that forms the comment to be echoed.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int echo(char ** args, writer * out) {
+    // Print the comments
+    while(*args) {
+        writer_puts(out, *args++);
+        writer_write(out, " ", 1);
+    }
+    writer_write(out, "\n", 1);
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Get help. The manual is displayed by the shell itself (one screen at a time
+ * if the shell is interactive and output is to a terminal).
+ *
+ * PARAMETERS
+ *     args: The arguments to the command. The first argument is a command or
+ *         heading of the manual to display. If there are no arguments, then
+ *         the whole manual is displayed.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int help(char ** args, writer * out) {
+    const char * topic = *args; // the command or heading to display
+    const manual_file * manual; // the manual
+    const manual_section * section = NULL; // the section of the manual to display
+
+    if (!(manual = manual_load(home))) {
+        // Create error message
+        const char msg[] = "Unable to open the readme file '%s'.";
+        char * err_msg;
+
+        // Memory allocation
+        err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(README_PATH) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+        // Output error message
+        sprintf(err_msg, msg, README_PATH);
+        err(err_msg);
+        proc_info.status = JOB_FAILURE_STATUS;
+    } else if (topic && !(section = manual_find(manual, topic))) {
+        // Create error message
+        const char msg[] = "No help found for '%s'.";
+        char * err_msg;
+
+        // Memory allocation
+        err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(topic) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+        // Output error message
+        sprintf(err_msg, msg, topic);
+        err(err_msg);
+        proc_info.status = JOB_FAILURE_STATUS;
+    } else {
+        const char * text = section ? section->start : manual->data; // the text to display
+        const size_t length = section ? (size_t) (section->end - section->start) : manual->size; // length of the text to display
+
+        // Make sure that previous output appears before the manual
+        writer_flush(out);
+
+        page(text, length, STDOUT_FILENO, interactive && isatty(STDOUT_FILENO));
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Remember or forget the full paths to commands. With no arguments, all
+ * remembered commands are printed. The argument HASH_RESET (defined in
+ * strings.h) forgets all remembered commands, and any other argument is taken
+ * to be a command whose full path should be found again.
+ *
+ * PARAMETERS
+ *     args: The first argument to the command.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int hash(char ** args, writer * out) {
+    if (!*args) {
+        // Print all remembered commands
+        path_cache_print(out);
+    }
+
+    while (*args) {
+        if (!strcmp(*args, HASH_RESET)) {
+            // Forget all remembered commands
+            path_cache_clear();
+        } else {
+            // Search PATH for the command again
+            path_cache_remove(*args);
+            if (!path_cache_find(*args)) {
+                // Create error message
+                const char msg[] = "Command '%s' could not be found.";
+                char * err_msg;
+
+                // Memory allocation
+                err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(*args) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+                // Output error message
+                sprintf(err_msg, msg, *args);
+                err(err_msg);
+                proc_info.status = JOB_FAILURE_STATUS;
+            }
+        }
+        args++;
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Pause the shell until a specified key is pressed. Terminal echo will be
+ * turned off and a specified prompt will be displayed.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command (unused).
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int pause_shell(char ** args, writer * out) {
+    struct termios old; // structure containing old terminal information
+    struct termios new; // structure containing new terminal information
+    FILE * tty; // pointer to the tty input device
+    char current_character; // the last key pressed
+
+    (void) args; // the command has no arguments
+
+    // Output pause message
+    writer_puts(out, PAUSE_MESSAGE);
+    writer_flush(out);
+
+    if (!(tty = fopen(ctermid(NULL), "re"))) sys_err("fopen"); // attempt to open tty device
+    setbuf(tty, NULL); // set the standard input stream unbuffered
+
+    if (tcgetattr(fileno(tty), &old)) sys_err("tcgetattr"); // attempt to save tty state
+    new = old; // copy the structure
+
+    /*
+     * Disables (note the tilde) the following:
+     *   - ECHO     Echo input characters
+     *   - ECHOE    Echo erase characters as backspace-space-backspace
+     *   - ECHOK    Echo a newline after a kill character
+     *   - ECHONL   Echo newline even if not echoing other characters
+     *   - ICANON   Enable erase, kill, werase, and rprnt special characters
+     */
+    new.c_lflag &= ~(ECHO | ECHOE | ECHOK | ECHONL | ICANON);
+
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &new)) sys_err("tcsetattr"); // change to the new terminal state
+
+    // Pause until the specified key is pressed
+    while ((current_character = getc(tty)) != EXIT_PAUSE_CHARACTER);
+
+    if (tcsetattr(fileno(tty), TCSAFLUSH, &old)) sys_err("tcsetattr"); // attempt to restore TTY state
+    writer_write(out, "\n", 1);
+
+#ifdef DEBUG
+    if (debug) {
+        // Create debug message
+        const char dbg[] = "Escape character '%c' detected. Resuming shell.";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (strlen(dbg) + 1 + 1) * sizeof(char)); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, dbg, EXIT_PAUSE_CHARACTER);
+        debug_message(dbg_msg);
+    }
+
+#endif // #ifdef DEBUG
+    if (fclose(tty)) sys_err("fclose"); // attempt to close /dev/tty
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Quit the shell.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command (unused).
+ *     out: The writer to which the output of the command is written. (unused)
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int quit(char ** args, writer * out) {
+    (void) args; // the command has no arguments
+    (void) out; // the command has no output
+
+    // Return an exit status indicating to the shell that it should quit
+    return EXIT_STATUS_QUIT;
+}
+
+/*
+ * Replace the shell with a command. The redirections of the command line are
+ * applied to the command.
+ *
+ * PARAMETERS
+ *     args: The command to execute, followed by its arguments.
+ *     out: The writer to which the output of the command is written. (unused)
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken (this
+ * function only returns if the command could not be executed).
+ */
+int exec_shell(char ** args, writer * out) {
+    (void) out; // the output is written by exec_program
+    if (!*args) {
+        err("No command was specified to replace the shell with.");
+        proc_info.status = JOB_FAILURE_STATUS;
+
+        // Return an exit status indicating to the shell that it should continue executing
+        return EXIT_STATUS_CONTINUE;
+    }
+
+    // The redirections have already been applied to the shell (see execute_command)
+    return replace_shell(args, FALSE);
+}
+
+/*
+ * Replace the shell with an external command, finding the full path to the
+ * command with path_cache_lookup (see exec_program). An error message is
+ * displayed if the command cannot be executed, and the failure is recorded as
+ * the status of the command.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *     redirect: Should the redirections of the command (see redirects) be
+ *         applied?
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken. If the
+ * command could not be found, the shell is unchanged and may continue.
+ * Otherwise, the shell has been prepared for the command and must quit.
+ */
+int replace_shell(char ** args, const boolean redirect) {
+    const char * file; // the full path to the command
+
+    if (!(file = path_cache_lookup(*args))) {
+        proc_info.status = W_EXITCODE(LAUNCH_NOT_FOUND_STATUS, 0);
+        errno = ENOENT;
+        error_launch(*args);
+
+        // Return an exit status indicating to the shell that it should continue executing
+        return EXIT_STATUS_CONTINUE;
+    }
+
+    exec_program(file, args, redirect);
+    if ((errno == ENOENT) && (file != *args)) {
+        // The remembered path no longer exists, so forget it and search PATH again
+        path_cache_remove(*args);
+        if ((file = path_cache_lookup(*args))) {
+            exec_program(file, args, redirect);
+        } else {
+            errno = ENOENT;
+        }
+    }
+
+    // Record the failure as the status of the command
+    proc_info.status = W_EXITCODE((errno == ENOENT) ? LAUNCH_NOT_FOUND_STATUS : LAUNCH_FAILED_STATUS, 0);
+    error_launch(*args);
+
+    // Return an exit status indicating to the shell that it should quit
+    return EXIT_STATUS_QUIT;
+}
+
+/*
+ * List the jobs, showing the job number, process ID, state, running time and
+ * command line of each job. Jobs which have finished are forgotten once they
+ * have been listed.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command (unused).
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int list_jobs(char ** args, writer * out) {
+    (void) args; // the command has no arguments
+
+    jobs_print_all(out);
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Wait for jobs to finish. With no arguments, the shell waits for every running
+ * job. Otherwise each argument is a job specification (see job_find) of a job
+ * to wait for.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int wait_for_jobs(char ** args, writer * out) {
+    job * j; // the job to wait for
+
+    // Make sure that previous output appears while the shell waits
+    writer_flush(out);
+
+    if (!*args) {
+        proc_info.status = jobs_wait_all();
+    }
+
+    while (*args) {
+        if (!(j = job_find(*args))) {
+            error_no_such_job(WAIT_COMMAND, *args);
+        } else if (j->state != JOB_STOPPED) {
+            proc_info.status = job_wait(j, FALSE);
+        }
+        args++;
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Continue a job in the foreground, and wait for it to finish or stop.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command. The first argument is a job
+ *         specification (see job_find). If there are no arguments, the current
+ *         job is continued.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int foreground_job(char ** args, writer * out) {
+    job * j; // the job to continue
+
+    if (!(j = job_find(*args))) {
+        error_no_such_job(FOREGROUND_COMMAND, *args);
+    } else {
+        writer_puts(out, j->command);
+        writer_write(out, "\n", 1);
+        writer_flush(out);
+
+        if (job_control && j->pgid) {
+            tcsetpgrp(STDIN_FILENO, j->pgid); // give the job the terminal before it continues
+        }
+        job_continue(j);
+        proc_info.status = job_wait(j, TRUE);
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Continue a stopped job in the background.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command. Each argument is a job specification
+ *         (see job_find). If there are no arguments, the current job is
+ *         continued.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int background_job(char ** args, writer * out) {
+    job * j; // the job to continue
+
+    do {
+        if (!(j = job_find(*args))) {
+            error_no_such_job(BACKGROUND_COMMAND, *args);
+        } else {
+            job_continue(j);
+            job_print(out, j);
+        }
+    } while (*args && *++args);
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Export variables to child processes. Each argument is either a variable name,
+ * or a variable assignment (which sets the variable before it is exported).
+ * With no arguments, the exported variables are printed.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command.
+ *     out: The writer to which the output of the command is written.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int export_variables(char ** args, writer * out) {
+    size_t length; // length of the variable name
+
+    if (!*args) {
+        // Print the exported variables
+        variables_print(out);
+    }
+
+    for (; *args; args++) {
+        if (!(length = variable_name_length(*args)) || ((*args)[length] && ((*args)[length] != ASSIGNMENT_CHARACTER))) {
+            error_variable_name(EXPORT_COMMAND, *args);
+        } else if ((*args)[length] == ASSIGNMENT_CHARACTER) {
+            variable_set(*args, length, *args + length + 1, TRUE);
+        } else {
+            variable_export(*args, length);
+        }
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Remove variables. Each argument is the name of a variable to remove.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command.
+ *     out: The writer to which the output of the command is written. (unused)
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int unset_variables(char ** args, writer * out) {
+    size_t length; // length of the variable name
+
+    (void) out; // the command has no output
+
+    for (; *args; args++) {
+        if (!(length = variable_name_length(*args)) || (*args)[length]) {
+            error_variable_name(UNSET_COMMAND, *args);
+        } else {
+            variable_unset(*args, length);
+        }
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Display an error message that an argument is not a valid variable name.
+ *
+ * PARAMETERS
+ *     command: The command to which the argument was given.
+ *     arg: The argument.
+ */
+void error_variable_name(const char * command, const char * arg) {
+    // Create error message
+    const char msg[] = "Invalid variable name for command '%s': '%s'.";
+    char * err_msg;
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(command) + strlen(arg) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, command, arg);
+    err(err_msg);
+    proc_info.status = JOB_FAILURE_STATUS;
+}
@@ -0,0 +1,178 @@
+/*
+ * input.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to split the input of the shell into
+ * lines without copying it through stdio.
+ *
+ * If the input is a regular file, the whole file is mapped into memory and
+ * each line is returned as a pointer into the mapping, so that the file is
+ * never copied. Otherwise (for pipes and terminals) the input is read in large
+ * blocks with read(2) into a buffer, and each line is returned as a pointer
+ * into the buffer, which is only valid until the next line is requested.
+ *
+ * Lines are found with memchr, which is vectorized by the C library.
+ */
+
+#include "../inc/input.h"
+
+/*
+ * Prepare to read lines from a file descriptor. A regular file is mapped into
+ * memory if possible; otherwise a read buffer is allocated.
+ *
+ * PARAMETERS
+ *     input: The input source to prepare.
+ *     fd: The file descriptor from which lines should be read.
+ */
+void input_open(input_source * input, const int fd) {
+    struct stat info; // information about the file
+
+    input->fd = fd;
+    input->mapped = FALSE;
+    input->start = 0;
+    input->scanned = 0;
+    input->end = 0;
+    input->eof = FALSE;
+
+    // Map a regular file into memory (empty files, such as those in /proc, must be read instead)
+    if (!fstat(fd, &info) && S_ISREG(info.st_mode) && (info.st_size > 0)) {
+        input->size = (size_t) info.st_size;
+        if ((input->data = (char *) mmap(NULL, input->size, PROT_READ, MAP_PRIVATE, fd, (off_t) 0)) != MAP_FAILED) {
+            madvise(input->data, input->size, MADV_SEQUENTIAL);
+            input->mapped = TRUE;
+            input->end = input->size;
+            input->eof = TRUE;
+            return;
+        }
+    }
+
+    // Memory allocation
+    input->size = INPUT_BLOCK_SIZE;
+    if (!(input->data = (char *) malloc(input->size))) sys_err("malloc"); // attempt to allocate memory for data
+}
+
+/*
+ * Prepare to read lines from a string (such as a command line given as an
+ * argument to the shell). The string is treated in the same way as a mapped
+ * file, and so must remain valid until input_close.
+ *
+ * PARAMETERS
+ *     input: The input source to prepare.
+ *     string: The string from which lines should be read (which need not be
+ *         null-terminated).
+ *     length: The length of the string.
+ */
+void input_open_string(input_source * input, const char * string, const size_t length) {
+    input->fd = -1;
+    input->mapped = TRUE;
+    input->data = (char *) string; // the string is never modified
+    input->size = length;
+    input->start = 0;
+    input->scanned = 0;
+    input->end = length;
+    input->eof = TRUE;
+}
+
+/*
+ * Get the next line of input. The line is NOT null-terminated, and includes the
+ * new-line character (unless it is the last line of the input and has none).
+ *
+ * PARAMETERS
+ *     input: The input source.
+ *     length: Set to the length of the line.
+ *
+ * RETURN VALUE
+ * A pointer to the line, or null at the end of the input. If the input is not
+ * mapped into memory, the line is only valid until the next call.
+ */
+const char * input_next_line(input_source * input, size_t * length) {
+    const char * line; // the next line
+    const char * new_line; // the new-line character at the end of the line
+    ssize_t num_read; // number of bytes read
+
+    while (TRUE) {
+        // Look for the end of the line in the data which has not been scanned
+        if ((new_line = (const char *) memchr(input->data + input->scanned, '\n', input->end - input->scanned))) {
+            line = input->data + input->start;
+            *length = (size_t) (new_line + 1 - line);
+            input->start += *length;
+            input->scanned = input->start;
+            return line;
+        }
+        input->scanned = input->end;
+
+        if (input->eof) {
+            // The last line may not end with a new-line character
+            if (input->start == input->end) {
+                return NULL;
+            }
+            line = input->data + input->start;
+            *length = input->end - input->start;
+            input->start = input->end;
+            input->scanned = input->end;
+            return line;
+        }
+
+        // Move the partial line to the start of the buffer, making it larger if the line fills it
+        if (input->start) {
+            memmove(input->data, input->data + input->start, input->end - input->start);
+            input->end -= input->start;
+            input->scanned -= input->start;
+            input->start = 0;
+        } else if (input->end == input->size) {
+            // Memory allocation
+            input->size *= 2;
+            if (!(input->data = (char *) realloc(input->data, input->size))) sys_err("realloc"); // attempt to reallocate memory for data
+        }
+
+        // Read another block of input
+        if ((num_read = read(input->fd, input->data + input->end, input->size - input->end)) > 0) {
+            input->end += (size_t) num_read;
+        } else if (!num_read || (errno != EINTR)) {
+            input->eof = TRUE;
+        }
+    }
+}
+
+/*
+ * Check whether the end of the input has been reached, so that no further
+ * command lines will be read. Only separators (such as blank lines) may remain.
+ * This never waits for input, so it is FALSE if more input may still arrive
+ * (for example, through a pipe).
+ *
+ * PARAMETERS
+ *     input: The input source.
+ *
+ * RETURN VALUE
+ * TRUE if the rest of the input is known to be empty, otherwise FALSE.
+ */
+boolean input_at_end(const input_source * input) {
+    if (!input->eof) {
+        return FALSE;
+    }
+
+    for (size_t i = input->start; i < input->end; ++i) {
+        if (!strchr(SEPARATORS, input->data[i])) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Release the memory used to read input. The file descriptor is not closed.
+ *
+ * PARAMETERS
+ *     input: The input source.
+ */
+void input_close(input_source * input) {
+    if (!input->mapped) {
+        free(input->data);
+    } else if (input->fd >= 0) {
+        munmap(input->data, input->size);
+    } // otherwise the input is a string which belongs to the caller
+    input->data = NULL;
+}
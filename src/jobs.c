@@ -0,0 +1,809 @@
+/*
+ * jobs.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the job table, which keeps track of the child processes
+ * launched by each command line.
+ *
+ * Child processes are reaped by a SIGCHLD handler, which stores each status in
+ * a ring buffer. The statuses are only applied to the job table by
+ * jobs_update, which runs with SIGCHLD blocked, so the job table is never
+ * modified by the signal handler. If the ring buffer is full, the handler
+ * leaves the remaining children to be reaped by jobs_update. A status may be
+ * applied before the process has been added to its job (for example, when the
+ * last command of a pipeline is an internal command which updates the job
+ * table), so the status of a process which belongs to no job is kept until
+ * the process is added to one (see job_add_process).
+ *
+ * When the shell is interactive (job_control), each job is run in its own
+ * process group, and the terminal is given to the foreground job while the
+ * shell waits for it.
+ */
+
+#include "../inc/jobs.h"
+
+job ** job_table = NULL; // the jobs (job number n is at index n - 1, null if unused)
+unsigned int job_table_size = 0; // number of entries in job_table
+unsigned long job_sequence = 0; // incremented each time a job is started, stopped or put in the background
+pid_t shell_pgid; // process group of the shell
+
+job_ring_entry job_ring[JOB_RING_SIZE]; // statuses reaped by the SIGCHLD handler
+volatile unsigned int job_ring_head = 0; // number of statuses added to job_ring (written by the SIGCHLD handler)
+volatile unsigned int job_ring_tail = 0; // number of statuses removed from job_ring
+job_ring_entry job_unclaimed[JOB_RING_SIZE]; // statuses of processes which belong to no job
+unsigned int job_num_unclaimed = 0; // number of entries of job_unclaimed which are used
+
+/*
+ * Prepare the job table and install the SIGCHLD handler. If job control is
+ * enabled, the shell is put in its own process group in the foreground of the
+ * terminal, and the job control signals are ignored.
+ */
+void jobs_setup(void) {
+    struct sigaction action; // the SIGCHLD handler
+
+    shell_pgid = getpgrp();
+
+    if (job_control) {
+        // Wait until the shell is in the foreground
+        while (tcgetpgrp(STDIN_FILENO) != (shell_pgid = getpgrp())) {
+            kill(-shell_pgid, SIGTTIN);
+        }
+
+        signal(SIGQUIT, SIG_IGN);
+        signal(SIGTSTP, SIG_IGN);
+        signal(SIGTTIN, SIG_IGN);
+        signal(SIGTTOU, SIG_IGN);
+
+        // Put the shell in its own process group (this fails harmlessly if the shell is a session leader)
+        setpgid(0, 0);
+        shell_pgid = getpgrp();
+        tcsetpgrp(STDIN_FILENO, shell_pgid);
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = jobs_sigchld_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART; // don't interrupt reading of commands
+    if (sigaction(SIGCHLD, &action, NULL)) sys_err("sigaction"); // attempt to install the SIGCHLD handler
+}
+
+/*
+ * Reap child processes whose status has changed, storing each status in
+ * job_ring. This is the SIGCHLD handler, so it must only call functions which
+ * are async-signal-safe.
+ *
+ * PARAMETERS
+ *     signal_number: The signal which was received (SIGCHLD).
+ */
+void jobs_sigchld_handler(int signal_number) {
+    const int saved_errno = errno; // errno of the interrupted code
+    pid_t pid; // process ID of a child process
+    int status; // status of the child process
+
+    (void) signal_number; // the handler is only installed for SIGCHLD
+
+    while (((job_ring_head - job_ring_tail) < JOB_RING_SIZE) && ((pid = waitpid(-1, &status, WNOHANG | WUNTRACED | WCONTINUED)) > 0)) {
+        job_ring[job_ring_head % JOB_RING_SIZE].pid = pid;
+        job_ring[job_ring_head % JOB_RING_SIZE].status = status;
+        job_ring_head++;
+    }
+
+    errno = saved_errno;
+}
+
+/*
+ * Apply the statuses of child processes which have changed to the job table.
+ * Statuses collected by the SIGCHLD handler are applied first, and then any
+ * children which the handler could not hold are reaped.
+ *
+ * RETURN VALUE
+ * The number of statuses applied.
+ */
+unsigned int jobs_update(void) {
+    sigset_t mask; // SIGCHLD
+    sigset_t old_mask; // the signal mask to restore
+    pid_t pid; // process ID of a child process
+    int status; // status of the child process
+    unsigned int num_statuses = 0; // number of statuses applied
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+    while (job_ring_tail != job_ring_head) {
+        job_set_status(job_ring[job_ring_tail % JOB_RING_SIZE].pid, job_ring[job_ring_tail % JOB_RING_SIZE].status);
+        job_ring_tail++;
+        num_statuses++;
+    }
+
+    while ((pid = waitpid(-1, &status, WNOHANG | WUNTRACED | WCONTINUED)) > 0) {
+        job_set_status(pid, status);
+        num_statuses++;
+    }
+
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+    return num_statuses;
+}
+
+/*
+ * Wait until the status of at least one child process has changed, and apply
+ * the new statuses to the job table.
+ */
+void jobs_wait_change(void) {
+    sigset_t mask; // SIGCHLD
+    sigset_t old_mask; // the signal mask to restore
+
+    // Block SIGCHLD so that no status can arrive between checking for statuses and suspending
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+    while (!jobs_update()) {
+        sigsuspend(&old_mask);
+    }
+
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+}
+
+/*
+ * Remove every job from the job table without waiting for it. This is used by
+ * a child process of the shell, which cannot wait for the jobs of the shell.
+ */
+void jobs_clear(void) {
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (job_table[i]) {
+            job_remove(job_table[i]);
+        }
+    }
+    job_num_unclaimed = 0;
+}
+
+/*
+ * Forget the statuses of processes which belong to no job. This is called once
+ * every process of a command has been added to its job, as any status left
+ * over belongs to a process which will never be added to a job (such as the
+ * fork server), and its process ID may be reused.
+ */
+void jobs_forget_unclaimed(void) {
+    job_num_unclaimed = 0;
+}
+
+/*
+ * Convert a status reported by waitpid to an exit status, in the same way as
+ * other shells: a process terminated by a signal has an exit status of 128
+ * plus the signal number.
+ *
+ * PARAMETERS
+ *     status: The status reported by waitpid.
+ *
+ * RETURN VALUE
+ * The exit status.
+ */
+int job_exit_status(const int status) {
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    } else if (WIFSTOPPED(status)) {
+        return 128 + WSTOPSIG(status);
+    }
+
+    return WEXITSTATUS(status);
+}
+
+/*
+ * Record a change in the status of a process, and update the state of the job
+ * to which it belongs. The status of a process which does not belong to a job
+ * is kept until the process is added to one (see job_add_process).
+ *
+ * PARAMETERS
+ *     pid: The process ID.
+ *     status: The status reported by waitpid.
+ */
+void job_set_status(const pid_t pid, const int status) {
+    job * j; // the current job
+    boolean running; // is any process of the job running?
+    boolean stopped; // is any process of the job stopped?
+    int old_state; // the state of the job before the change
+
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (!(j = job_table[i])) {
+            continue;
+        }
+
+        for (unsigned int k = 0; k < j->num_processes; ++k) {
+            if (j->processes[k].pid != pid) {
+                continue;
+            }
+
+            // Update the process
+            if (WIFSTOPPED(status)) {
+                j->processes[k].state = JOB_STOPPED;
+            } else if (WIFCONTINUED(status)) {
+                j->processes[k].state = JOB_RUNNING;
+            } else {
+                j->processes[k].state = JOB_DONE;
+                j->processes[k].status = status;
+            }
+
+            // Update the job
+            running = FALSE;
+            stopped = FALSE;
+            for (unsigned int p = 0; p < j->num_processes; ++p) {
+                running |= (j->processes[p].state == JOB_RUNNING);
+                stopped |= (j->processes[p].state == JOB_STOPPED);
+            }
+
+            old_state = j->state;
+            j->state = running ? JOB_RUNNING : (stopped ? JOB_STOPPED : JOB_DONE);
+            if (j->state == JOB_DONE) {
+                j->status = j->processes[j->num_processes - 1].status;
+            }
+            if (j->state != old_state) {
+                j->notified = FALSE;
+                if (j->state == JOB_STOPPED) {
+                    j->sequence = ++job_sequence;
+                }
+            }
+            return;
+        }
+    }
+
+    // The process belongs to no job (yet), so keep its latest status
+    for (unsigned int i = 0; i < job_num_unclaimed; ++i) {
+        if (job_unclaimed[i].pid == pid) {
+            job_unclaimed[i].status = status;
+            return;
+        }
+    }
+    if (job_num_unclaimed < JOB_RING_SIZE) {
+        job_unclaimed[job_num_unclaimed].pid = pid;
+        job_unclaimed[job_num_unclaimed].status = status;
+        job_num_unclaimed++;
+    }
+}
+
+/*
+ * Create a job for a command. The job is given the lowest unused job number.
+ *
+ * PARAMETERS
+ *     command: The command which forms the job (which need not be
+ *         null-terminated), or null if it is unknown.
+ *     length: The length of the command.
+ *
+ * RETURN VALUE
+ * A pointer to the new job.
+ */
+job * job_create(const char * command, size_t length) {
+    unsigned int i; // index of the new job
+    job * j; // the new job
+
+    // Find an unused job number
+    for (i = 0; (i < job_table_size) && job_table[i]; ++i);
+    if (i == job_table_size) {
+        // Memory allocation
+        if (!(job_table = (job **) realloc(job_table, (size_t) ((job_table_size + 1) * sizeof(job *))))) sys_err("realloc"); // attempt to reallocate memory for job_table
+        job_table_size++;
+    }
+
+    // Memory allocation
+    if (!(j = (job *) malloc(sizeof(job)))) sys_err("malloc"); // attempt to allocate memory for j
+
+    if (!command) {
+        command = "";
+        length = 0;
+    }
+
+    // Remove trailing separators (such as the new-line character) from the command
+    while (length && strchr(SEPARATORS, command[length - 1])) {
+        length--;
+    }
+
+    // Memory allocation
+    if (!(j->command = (char *) malloc((size_t) ((length + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for command
+    memcpy(j->command, command, length);
+    j->command[length] = '\0';
+
+    j->number = i + 1;
+    j->pgid = 0;
+    j->started = time(NULL);
+    j->processes = NULL;
+    j->num_processes = 0;
+    j->state = JOB_DONE;
+    j->status = 0;
+    j->notified = TRUE;
+    j->sequence = ++job_sequence;
+    job_table[i] = j;
+
+    return j;
+}
+
+/*
+ * Add a process to a job. If job control is enabled, the first process of the
+ * job is the leader of its process group. If the status of the process has
+ * already been reaped, then it is applied to the job.
+ *
+ * PARAMETERS
+ *     j: The job.
+ *     pid: The process ID of the process.
+ */
+void job_add_process(job * j, const pid_t pid) {
+    // Memory allocation
+    if (!(j->processes = (job_process *) realloc(j->processes, (size_t) ((j->num_processes + 1) * sizeof(job_process))))) sys_err("realloc"); // attempt to reallocate memory for processes
+
+    j->processes[j->num_processes].pid = pid;
+    j->processes[j->num_processes].status = 0;
+    j->processes[j->num_processes].state = JOB_RUNNING;
+    j->num_processes++;
+    j->state = JOB_RUNNING;
+
+    if (job_control && !j->pgid) {
+        j->pgid = pid;
+    }
+
+    // Claim a status which arrived before the process was added
+    for (unsigned int i = 0; i < job_num_unclaimed; ++i) {
+        if (job_unclaimed[i].pid == pid) {
+            const int status = job_unclaimed[i].status; // the status of the process
+
+            job_unclaimed[i] = job_unclaimed[--job_num_unclaimed];
+            job_set_status(pid, status);
+            break;
+        }
+    }
+}
+
+/*
+ * Remove a job from the job table.
+ *
+ * PARAMETERS
+ *     j: The job to remove.
+ */
+void job_remove(job * j) {
+    job_table[j->number - 1] = NULL;
+    free(j->command);
+    free(j->processes);
+    free(j);
+}
+
+/*
+ * Wait for a job to finish or stop. If the job finishes, it is removed from the
+ * job table.
+ *
+ * PARAMETERS
+ *     j: The job to wait for.
+ *     foreground: Should the job be given the terminal (if job control is
+ *         enabled) while the shell waits?
+ *
+ * RETURN VALUE
+ * The status of the last process of the job, as reported by waitpid.
+ */
+int job_wait(job * j, const boolean foreground) {
+    sigset_t mask; // SIGCHLD
+    sigset_t old_mask; // the signal mask to restore
+    int status; // status of the job
+#ifdef DEBUG
+    const unsigned int number = j->number; // the job number (for debug messages)
+
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Parent process waiting for job %u [PID: %d] to return.";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + digits((int) j->number) + digits(j->processes[0].pid) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, j->number, j->processes[0].pid);
+        debug_message(dbg_msg);
+    }
+
+#endif // #ifdef DEBUG
+    if (foreground && job_control && j->pgid) {
+        tcsetpgrp(STDIN_FILENO, j->pgid);
+    }
+
+    // Block SIGCHLD so that no status can arrive between checking the job and suspending
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, &old_mask);
+
+    jobs_update();
+    while (j->state == JOB_RUNNING) {
+        sigsuspend(&old_mask);
+        jobs_update();
+    }
+
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+    if (foreground && job_control) {
+        tcsetpgrp(STDIN_FILENO, shell_pgid);
+    }
+
+    if (j->state == JOB_STOPPED) {
+        status = j->processes[j->num_processes - 1].status;
+        if (foreground && interactive) {
+            // Report the stopped job straight away
+            writer_write(&shell_output, "\n", 1);
+            job_print(&shell_output, j);
+            j->notified = TRUE;
+        }
+    } else {
+        status = j->status;
+        job_remove(j);
+    }
+#ifdef DEBUG
+
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Job %u has returned with status: %d.";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + digits((int) number) + digits(status) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, number, status);
+        debug_message(dbg_msg);
+    }
+#endif // #ifdef DEBUG
+
+    return status;
+}
+
+/*
+ * Wait for every running job to finish or stop. Jobs which have already
+ * finished are removed from the job table.
+ *
+ * RETURN VALUE
+ * Always 0 (the exit status of 'wait' without operands, whatever the statuses
+ * of the jobs were).
+ */
+int jobs_wait_all(void) {
+    jobs_update();
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (!job_table[i] || (job_table[i]->state == JOB_STOPPED)) {
+            continue;
+        }
+
+        if (job_table[i]->state == JOB_DONE) {
+            job_remove(job_table[i]);
+        } else {
+            job_wait(job_table[i], FALSE);
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Check whether any job has not yet finished.
+ *
+ * RETURN VALUE
+ * TRUE if at least one job is running or stopped, otherwise FALSE.
+ */
+boolean jobs_pending(void) {
+    jobs_update();
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (job_table[i] && (job_table[i]->state != JOB_DONE)) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Report that a job has been started in the background. The job number and
+ * the process ID of the last process are output if the shell is interactive.
+ *
+ * PARAMETERS
+ *     j: The job.
+ */
+void job_background(job * j) {
+    j->sequence = ++job_sequence;
+
+    if (interactive) {
+        writer_printf(&shell_output, "[%u] %d\n", j->number, (int) j->processes[j->num_processes - 1].pid);
+    }
+#ifdef DEBUG
+
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Parent process continuing without waiting for job %u [PID: %d] to return.";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + digits((int) j->number) + digits(j->processes[0].pid) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, j->number, j->processes[0].pid);
+        debug_message(dbg_msg);
+    }
+#endif // #ifdef DEBUG
+}
+
+/*
+ * Continue a stopped job by sending it SIGCONT. The job becomes the current
+ * job.
+ *
+ * PARAMETERS
+ *     j: The job.
+ */
+void job_continue(job * j) {
+    for (unsigned int i = 0; i < j->num_processes; ++i) {
+        if (j->processes[i].state == JOB_STOPPED) {
+            j->processes[i].state = JOB_RUNNING;
+        }
+    }
+
+    if (j->state == JOB_STOPPED) {
+        j->state = JOB_RUNNING;
+        job_signal(j, SIGCONT);
+    }
+
+    j->notified = TRUE;
+    j->sequence = ++job_sequence;
+}
+
+/*
+ * Find a job from a job specification. A job specification is the job
+ * character (defined in strings.h) followed by a job number, or the process ID
+ * of one of the processes of the job. If the specification is null, the job
+ * character alone, or the job character repeated or followed by '+', the
+ * current job (the job most recently started, stopped or put in the
+ * background) is found.
+ *
+ * PARAMETERS
+ *     spec: A null-terminated string containing the job specification, or
+ *         null.
+ *
+ * RETURN VALUE
+ * A pointer to the job, or null if no job matches the specification.
+ */
+job * job_find(const char * spec) {
+    char * end; // end of the number in spec
+    unsigned long number; // the job number or process ID
+
+    jobs_update();
+
+    if (!spec || ((spec[0] == JOB_CHARACTER) && (!spec[1] || (((spec[1] == JOB_CHARACTER) || (spec[1] == '+')) && !spec[2])))) {
+        return job_current();
+    }
+
+    number = strtoul((*spec == JOB_CHARACTER) ? spec + 1 : spec, &end, 10);
+    if (*end || (end == spec) || !number) {
+        return NULL;
+    }
+
+    if (*spec == JOB_CHARACTER) {
+        return (number <= job_table_size) ? job_table[number - 1] : NULL;
+    }
+
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        for (unsigned int k = 0; job_table[i] && (k < job_table[i]->num_processes); ++k) {
+            if ((unsigned long) job_table[i]->processes[k].pid == number) {
+                return job_table[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Find the current job (the job most recently started, stopped or put in the
+ * background).
+ *
+ * RETURN VALUE
+ * A pointer to the current job, or null if there are no jobs.
+ */
+job * job_current(void) {
+    job * current = NULL; // the current job
+
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (job_table[i] && (!current || (job_table[i]->sequence > current->sequence))) {
+            current = job_table[i];
+        }
+    }
+
+    return current;
+}
+
+/*
+ * Print the state of a job: its number ('+' marks the current job), the
+ * process ID of its first process, its state, how long ago it was started and
+ * its command line.
+ *
+ * PARAMETERS
+ *     out: The writer to print to.
+ *     j: The job.
+ */
+void job_print(writer * out, const job * j) {
+    const job * current = job_current(); // the current job
+    char state[32]; // description of the state of the job
+
+    switch (j->state) {
+        case JOB_RUNNING:
+            strcpy(state, "Running");
+            break;
+
+        case JOB_STOPPED:
+            strcpy(state, "Stopped");
+            break;
+
+        default: // JOB_DONE
+            if (WIFSIGNALED(j->status)) {
+                snprintf(state, sizeof(state), "%s", strsignal(WTERMSIG(j->status)));
+            } else if (WEXITSTATUS(j->status)) {
+                snprintf(state, sizeof(state), "Exit %d", WEXITSTATUS(j->status));
+            } else {
+                strcpy(state, "Done");
+            }
+    }
+
+    writer_printf(out, "[%u]%c %-7d %-12s %5lds  %s\n", j->number, (j == current) ? '+' : ' ', (int) j->processes[0].pid, state, (long) difftime(time(NULL), j->started), j->command);
+}
+
+/*
+ * Print the state of every job. Jobs which have finished are removed from the
+ * job table once they have been printed.
+ *
+ * PARAMETERS
+ *     out: The writer to print to.
+ */
+void jobs_print_all(writer * out) {
+    jobs_update();
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (job_table[i]) {
+            job_print(out, job_table[i]);
+            job_table[i]->notified = TRUE;
+        }
+    }
+
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (job_table[i] && (job_table[i]->state == JOB_DONE)) {
+            job_remove(job_table[i]);
+        }
+    }
+}
+
+/*
+ * Report jobs which have finished or stopped since they were last reported.
+ * This is only done if the shell is interactive; otherwise finished jobs are
+ * kept until they are reported by the jobs or wait commands.
+ */
+void jobs_notify(void) {
+    if (!interactive) {
+        return;
+    }
+
+    jobs_update();
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (job_table[i] && !job_table[i]->notified && (job_table[i]->state != JOB_RUNNING)) {
+            job_print(&shell_output, job_table[i]);
+            job_table[i]->notified = TRUE;
+        }
+    }
+
+    for (unsigned int i = 0; i < job_table_size; ++i) {
+        if (job_table[i] && job_table[i]->notified && (job_table[i]->state == JOB_DONE)) {
+            job_remove(job_table[i]);
+        }
+    }
+}
+
+/*
+ * Get the process group in which a process should be launched.
+ *
+ * PARAMETERS
+ *     leader: The process group leader of the job, or 0 if the process will be
+ *         the first process of the job.
+ *
+ * RETURN VALUE
+ * The process group to launch the process in (0 for a new process group), or
+ * -1 if job control is disabled and the process should stay in the process
+ * group of the shell.
+ */
+pid_t job_process_group(const pid_t leader) {
+    return job_control ? leader : -1;
+}
+
+/*
+ * Prepare a forked child process to run as part of a job. The child joins its
+ * process group (and takes the terminal if it is in the foreground), and the
+ * signals ignored by the shell are restored to their default actions.
+ *
+ * PARAMETERS
+ *     pgid: The process group to join (0 for a new process group), or -1.
+ *     foreground: Will the job run in the foreground?
+ */
+void job_child_setup(const pid_t pgid, const boolean foreground) {
+    sigset_t mask; // an empty signal mask
+
+    if (pgid >= 0) {
+        setpgid(0, pgid);
+        if (foreground) {
+            tcsetpgrp(STDIN_FILENO, getpgrp());
+        }
+    }
+
+    if (job_control) {
+        signal(SIGQUIT, SIG_DFL);
+        signal(SIGTSTP, SIG_DFL);
+        signal(SIGTTIN, SIG_DFL);
+        signal(SIGTTOU, SIG_DFL);
+    }
+
+    // Background jobs without job control share the process group of the shell, so they continue to ignore SIGINT
+    if (foreground || job_control) {
+        signal(SIGINT, SIG_DFL);
+    }
+
+    signal(SIGCHLD, SIG_DFL);
+    sigemptyset(&mask);
+    sigprocmask(SIG_SETMASK, &mask, NULL);
+}
+
+/*
+ * Put a newly launched child process in its process group. This is also done
+ * by the child process, so that the process group exists whichever process
+ * runs first.
+ *
+ * PARAMETERS
+ *     pid: The process ID of the child process.
+ *     pgid: The process group to join (0 for a new process group), or -1.
+ */
+void job_parent_setup(const pid_t pid, const pid_t pgid) {
+    if ((pid > 0) && (pgid >= 0)) {
+        setpgid(pid, pgid ? pgid : pid); // this fails harmlessly if the child has already executed a program
+    }
+}
+
+/*
+ * Send a signal to every process of a job.
+ *
+ * PARAMETERS
+ *     j: The job.
+ *     signal_number: The signal to send.
+ */
+void job_signal(const job * j, const int signal_number) {
+    if (j->pgid) {
+        kill(-j->pgid, signal_number);
+        return;
+    }
+
+    for (unsigned int i = 0; i < j->num_processes; ++i) {
+        if (j->processes[i].state != JOB_DONE) {
+            kill(j->processes[i].pid, signal_number);
+        }
+    }
+}
+
+/*
+ * Display an error message that a job could not be found.
+ *
+ * PARAMETERS
+ *     command: A null-terminated string containing the command for which the
+ *         job could not be found.
+ *     spec: A null-terminated string containing the job specification, or
+ *         null for the current job.
+ */
+void error_no_such_job(const char * command, const char * spec) {
+    // Create error message
+    const char msg[] = "No such job for command '%s': '%s'.";
+    char * err_msg;
+
+    if (!spec) {
+        spec = "current";
+    }
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(command) + strlen(spec) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, command, spec);
+    err(err_msg);
+    proc_info.status = JOB_FAILURE_STATUS;
+}
@@ -0,0 +1,506 @@
+/*
+ * launch.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to launch and wait for child
+ * processes.
+ *
+ * By default, programs are launched with posix_spawn, which (in glibc) creates
+ * the child with clone(CLONE_VM | CLONE_VFORK) so that the page tables of the
+ * shell are never copied. Compiling with USE_FORK (see the Makefile) restores
+ * the traditional fork/exec path so that the two can be compared.
+ */
+
+#include "../inc/launch.h"
+
+char ** child_envp = NULL; // the environment of child processes (null if it must be rebuilt)
+size_t child_envp_size; // space which child_envp occupies in a new process image
+size_t child_envp_longest; // length of the longest string in child_envp
+unsigned long child_envp_generation; // value of variables_generation when child_envp was built
+
+/*
+ * Build the environment for a child process. This consists of the exported
+ * variables of the shell, with the 'parent' environment variable set to the
+ * path to the shell (overwriting any existing value).
+ *
+ * The memory allocated by this function must be freed by the caller with
+ * free_environment.
+ *
+ * RETURN VALUE
+ * A pointer to a null-terminated array of environment strings.
+ */
+char ** build_environment(void) {
+    const char parent[] = "parent="; // the 'parent' environment variable
+    char * parent_variable; // the 'parent' environment variable of the child process
+
+    // Memory allocation
+    if (!(parent_variable = (char *) malloc((size_t) ((strlen(parent) + strlen(path) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for the 'parent' environment variable
+
+    // Set the 'parent' environment variable
+    sprintf(parent_variable, "%s%s", parent, path);
+
+    return variables_environment(parent_variable);
+}
+
+/*
+ * Free an environment created by build_environment.
+ *
+ * PARAMETERS
+ *     envp: The environment to be freed.
+ */
+void free_environment(char ** envp) {
+    free(*envp); // the 'parent' environment variable is the only string owned by envp
+    free(envp);
+}
+
+/*
+ * Get the environment for child processes. The environment is built (see
+ * build_environment) the first time it is needed, and then reused for every
+ * child process until the exported variables change, so that launching a
+ * program does not copy the environment.
+ *
+ * RETURN VALUE
+ * A pointer to a null-terminated array of environment strings, which belongs to
+ * the shell and must not be freed by the caller.
+ */
+char ** child_environment(void) {
+    if (child_envp && (child_envp_generation != variables_generation)) {
+        child_environment_reset();
+    }
+
+    if (!child_envp) {
+        child_envp = build_environment();
+        child_envp_generation = variables_generation;
+        child_envp_size = argument_size(child_envp);
+        child_envp_longest = longest_argument(child_envp);
+#ifdef DEBUG
+
+        if (debug) {
+            debug_message("Built the environment for child processes.");
+        }
+#endif // #ifdef DEBUG
+    }
+
+    return child_envp;
+}
+
+/*
+ * Forget the environment for child processes, so that it is built again when
+ * it is next needed.
+ */
+void child_environment_reset(void) {
+    if (child_envp) {
+        free_environment(child_envp);
+        child_envp = NULL;
+    }
+}
+
+/*
+ * Launch a program in a child process. The program is executed directly,
+ * without searching the directories listed in the PATH environment variable
+ * (see path_cache_lookup). The redirections of the command (see redirects) are
+ * applied after stdin and stdout have been connected to input_fd and
+ * output_fd, so that they take precedence over a pipe.
+ *
+ * PARAMETERS
+ *     file: The full path to the program to execute.
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *     input_fd: The file descriptor to be used as stdin by the child process,
+ *         or -1 if stdin should not be redirected.
+ *     output_fd: The file descriptor to be used as stdout by the child process,
+ *         or -1 if stdout should not be redirected.
+ *     pgid: The process group for the child process (0 for a new process
+ *         group), or -1 if the child process should stay in the process group
+ *         of the shell (see job_process_group).
+ *
+ * RETURN VALUE
+ * The process ID of the child process on success. On failure, -1 is returned
+ * and errno is set to indicate the error.
+ */
+pid_t launch_program(const char * file, char ** args, const int input_fd, const int output_fd, const pid_t pgid) {
+    pid_t pid; // process ID of the child process
+    int error; // error number reported by the child process
+    char ** envp = child_environment(); // the environment of the child process
+    size_t size = argument_size(args) + child_envp_size; // space required for the arguments and environment
+
+#ifdef DEBUG
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Attempting to execute '%s' in child process.";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(file) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, file);
+        debug_message(dbg_msg);
+    }
+
+#endif // #ifdef DEBUG
+    // Make sure that the arguments and environment will fit in the new process image
+    if ((size > argument_limit()) || (longest_argument(args) >= argument_string_limit()) || (child_envp_longest >= argument_string_limit())) {
+#ifdef DEBUG
+        if (debug) {
+            // Create debug message
+            const char msg[] = "Arguments and environment of '%s' require %lu bytes, but the limit is %lu bytes.";
+            char * dbg_msg;
+
+            // Memory allocation
+            dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(file) + 2 * 20 /* for numbers */ + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+            // Output debug message
+            sprintf(dbg_msg, msg, file, (unsigned long) size, (unsigned long) argument_limit());
+            debug_message(dbg_msg);
+        }
+
+#endif // #ifdef DEBUG
+        errno = E2BIG;
+        return -1;
+    }
+
+    // Let the fork server launch the program if it is running (see zygote.c)
+    if (zygote_running() && zygote_launch(file, args, envp, input_fd, output_fd, pgid, &pid)) {
+        error = errno;
+        job_parent_setup(pid, pgid);
+        errno = error;
+        return pid;
+    }
+
+#ifdef USE_FORK
+    int error_pipe[2]; // used by the child process to report a failed exec
+
+    // The write end is closed by a successful exec, so the parent reads EOF
+    if (pipe2(error_pipe, O_CLOEXEC)) sys_err("pipe2"); // attempt to create the error pipe
+
+    // Fork the current process
+    switch (pid = fork()) {
+        case -1: // fork failed
+            sys_err("fork");
+            break;
+
+        case 0: // child
+            close(error_pipe[0]);
+            job_child_setup(pgid, !proc_info.dont_wait);
+
+            // Redirect input if necessary
+            if (input_fd >= 0) {
+                dup2(input_fd, STDIN_FILENO);
+            }
+
+            // Redirect output if necessary
+            if (output_fd >= 0) {
+                dup2(output_fd, STDOUT_FILENO);
+            }
+
+            // Apply the redirections of the command
+            redirect_apply(&redirects, NULL);
+
+            // Execute the command with the appropriate arguments
+            execve(file, args, envp);
+
+            // If execution reaches this line, an error has occured as execve should never return
+            error = errno;
+            if (write(error_pipe[1], &error, sizeof(error))) {} // nothing more can be done if this fails
+            _exit(127);
+
+        default: // parent
+            close(error_pipe[1]);
+            job_parent_setup(pid, pgid);
+
+            // Check whether the child process managed to execute the program
+            if (read(error_pipe[0], &error, sizeof(error)) == (ssize_t) sizeof(error)) {
+                waitpid(pid, NULL, 0); // reap the failed child process
+                pid = -1;
+            } else {
+                error = 0;
+            }
+            close(error_pipe[0]);
+    }
+#else
+    posix_spawn_file_actions_t actions; // redirections to be performed in the child process
+    posix_spawnattr_t attributes; // process group and signal handling of the child process
+    sigset_t defaults; // signals to be restored to their default actions in the child process
+    sigset_t mask; // signal mask of the child process
+    short flags = POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK; // attributes to be applied
+
+    if ((error = posix_spawn_file_actions_init(&actions))) {
+        errno = error;
+        sys_err("posix_spawn_file_actions_init");
+    }
+    if ((error = posix_spawnattr_init(&attributes))) {
+        errno = error;
+        sys_err("posix_spawnattr_init");
+    }
+
+    // Restore the signals ignored by the shell (as job_child_setup does)
+    sigemptyset(&defaults);
+    if (job_control) {
+        sigaddset(&defaults, SIGQUIT);
+        sigaddset(&defaults, SIGTSTP);
+        sigaddset(&defaults, SIGTTIN);
+        sigaddset(&defaults, SIGTTOU);
+    }
+    if (!proc_info.dont_wait || job_control) {
+        sigaddset(&defaults, SIGINT);
+    }
+    sigaddset(&defaults, SIGCHLD);
+    sigemptyset(&mask);
+    posix_spawnattr_setsigdefault(&attributes, &defaults);
+    posix_spawnattr_setsigmask(&attributes, &mask);
+
+    // Put the child process in its process group
+    if (pgid >= 0) {
+        flags |= POSIX_SPAWN_SETPGROUP;
+        posix_spawnattr_setpgroup(&attributes, pgid);
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 35)))
+
+        // Give a new foreground job the terminal before the program starts
+        if (!pgid && !proc_info.dont_wait && job_control && (error = posix_spawn_file_actions_addtcsetpgrp_np(&actions, STDIN_FILENO))) {
+            errno = error;
+            sys_err("posix_spawn_file_actions_addtcsetpgrp_np");
+        }
+#endif // #if defined(__GLIBC__) && ...
+    }
+    posix_spawnattr_setflags(&attributes, flags);
+
+    // Redirect input if necessary
+    if ((input_fd >= 0) && (error = posix_spawn_file_actions_adddup2(&actions, input_fd, STDIN_FILENO))) {
+        errno = error;
+        sys_err("posix_spawn_file_actions_adddup2");
+    }
+
+    // Redirect output if necessary
+    if ((output_fd >= 0) && (error = posix_spawn_file_actions_adddup2(&actions, output_fd, STDOUT_FILENO))) {
+        errno = error;
+        sys_err("posix_spawn_file_actions_adddup2");
+    }
+
+    // Apply the redirections of the command
+    for (unsigned int i = 0; i < redirects.num_entries; ++i) {
+        const redirection * r = &redirects.entries[i]; // the current redirection
+
+        if (r->source < 0) {
+            if ((error = posix_spawn_file_actions_addclose(&actions, r->fd))) {
+                errno = error;
+                sys_err("posix_spawn_file_actions_addclose");
+            }
+        } else if ((r->source != r->fd) && (error = posix_spawn_file_actions_adddup2(&actions, r->source, r->fd))) {
+            errno = error;
+            sys_err("posix_spawn_file_actions_adddup2");
+        }
+    }
+
+    // Execute the command with the appropriate arguments
+    if ((error = posix_spawn(&pid, file, &actions, &attributes, args, envp))) {
+        pid = -1;
+    }
+    job_parent_setup(pid, pgid);
+
+    // Clean up
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+#endif // #ifdef USE_FORK
+
+    errno = error;
+    return pid;
+}
+
+/*
+ * Replace the shell with a program, in the same way as launch_program would
+ * launch it in a child process: the redirections are applied (unless they
+ * have already been applied to the shell), the signals
+ * ignored by the shell are restored to their default actions and the program
+ * is given the environment for child processes (see child_environment). This
+ * is used when the shell has nothing left to do after the program finishes, to
+ * save creating (and waiting for) a child process.
+ *
+ * The state of the shell is changed before the program is executed, so the
+ * shell cannot continue executing commands if this function returns.
+ *
+ * PARAMETERS
+ *     file: The full path to the program to execute.
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *     redirect: Should the redirections of the command (see redirects) be
+ *         applied?
+ *
+ * RETURN VALUE
+ * This function only returns on failure, in which case errno is set to
+ * indicate the error.
+ */
+void exec_program(const char * file, char ** args, const boolean redirect) {
+#ifdef DEBUG
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Attempting to execute '%s' in place of the shell.";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(file) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, file);
+        debug_message(dbg_msg);
+    }
+
+#endif // #ifdef DEBUG
+    // Make sure that buffered output is not lost
+    writer_flush(&shell_output);
+    fflush(stderr);
+
+    // The program is not a job of the shell, so it stays in the process group of the shell
+    job_child_setup(-1, TRUE);
+
+    // Apply the redirections of the command if necessary
+    if (redirect) {
+        redirect_apply(&redirects, NULL);
+    }
+
+    // Execute the command with the appropriate arguments
+    execve(file, args, child_environment());
+}
+
+/*
+ * Calculate the space which an array of strings will occupy in a new process
+ * image, in the same way as the kernel does when checking against ARG_MAX
+ * (each string, its null character and a pointer to it).
+ *
+ * PARAMETERS
+ *     strings: A pointer to an array of character strings. MUST be terminated
+ *         by a null entry.
+ *
+ * RETURN VALUE
+ * The number of bytes required.
+ */
+size_t argument_size(char ** strings) {
+    size_t size = sizeof(char *); // for the null entry
+
+    while (*strings) {
+        size += strlen(*strings++) + 1 /* for null character */ + sizeof(char *);
+    }
+
+    return size;
+}
+
+/*
+ * Find the length of the longest string in an array of strings.
+ *
+ * PARAMETERS
+ *     strings: A pointer to an array of character strings. MUST be terminated
+ *         by a null entry.
+ *
+ * RETURN VALUE
+ * The length of the longest string.
+ */
+size_t longest_argument(char ** strings) {
+    size_t longest = 0; // length of the longest string
+    size_t length; // length of the current string
+
+    while (*strings) {
+        if ((length = strlen(*strings++)) > longest) {
+            longest = length;
+        }
+    }
+
+    return longest;
+}
+
+/*
+ * Get the maximum space which the arguments and environment of a new process
+ * may occupy (ARG_MAX). This is only determined the first time the function is
+ * called.
+ *
+ * RETURN VALUE
+ * The maximum number of bytes.
+ */
+size_t argument_limit(void) {
+    static long limit = 0; // the maximum number of bytes
+
+    if (!limit && ((limit = sysconf(_SC_ARG_MAX)) <= 0)) {
+        limit = _POSIX_ARG_MAX;
+    }
+
+    return (size_t) limit;
+}
+
+/*
+ * Get the maximum length of a single argument or environment string (including
+ * its null character). Linux limits each string to LAUNCH_ARG_STRLEN_PAGES
+ * pages, regardless of ARG_MAX.
+ *
+ * RETURN VALUE
+ * The maximum number of bytes.
+ */
+size_t argument_string_limit(void) {
+    static long limit = 0; // the maximum number of bytes
+
+    if (!limit && ((limit = sysconf(_SC_PAGESIZE)) <= 0)) {
+        limit = 4096;
+    }
+
+    return (size_t) limit * LAUNCH_ARG_STRLEN_PAGES;
+}
+
+/*
+ * Display an error message that a program could not be launched. Uses the error
+ * number of the last experienced error to generate an error message.
+ *
+ * PARAMETERS
+ *     file: A null-terminated string containing the program that could not be
+ *         launched.
+ */
+void error_launch(const char * file) {
+    // Create error message
+    const char msg[] = "Unable to execute '%s': %s.";
+    const char * reason = strerror(errno); // the reason for the failure
+    char * err_msg;
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(file) + strlen(reason) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, file, reason);
+    err(err_msg);
+}
+
+/*
+ * Wait for the most recently launched child process (stored in proc_info) to
+ * return, unless it has been launched in the background.
+ */
+void wait_for_process(void) {
+    wait_for_processes(&proc_info.pid, 1);
+}
+
+/*
+ * Wait for a group of child processes (such as the commands of a pipeline) to
+ * return, unless they have been launched in the background. The processes are
+ * added to the job table as a single job. The status of the last process is
+ * stored in proc_info.
+ *
+ * PARAMETERS
+ *     pids: The process IDs of the child processes.
+ *     num_pids: The number of child processes.
+ */
+void wait_for_processes(const pid_t * pids, const unsigned int num_pids) {
+    job * j; // the job
+
+    if (!num_pids) {
+        return;
+    }
+
+    j = job_create(proc_info.command, proc_info.command ? strlen(proc_info.command) : 0);
+    for (unsigned int i = 0; i < num_pids; ++i) {
+        job_add_process(j, pids[i]);
+    }
+    jobs_forget_unclaimed();
+
+    if (proc_info.dont_wait) {
+        job_background(j);
+    } else {
+        proc_info.status = job_wait(j, TRUE);
+    }
+}
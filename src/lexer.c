@@ -0,0 +1,331 @@
+/*
+ * lexer.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the lexer used to split a command line into arguments.
+ *
+ * Every character is classified with a single lookup in a 256 entry table
+ * (built from SEPARATORS, QUOTATION_MARKS, OPERATORS, EXPANSION_CHARACTER and
+ * GLOB_CHARACTERS), and quotation marks are removed while the tokens are
+ * copied, so each character is only examined once. Where SSE2 is available, runs of ordinary
+ * characters are found sixteen bytes at a time.
+ *
+ * Tokens are written to a buffer supplied by the caller. Each token is
+ * null-terminated and is preceded by a byte of token flags, so that (for
+ * example) a quoted "|" can be told apart from the pipe character.
+ *
+ * Variables are not expanded by the lexer, because command lines may be split
+ * into tokens (by the batch reader) before earlier command lines have set the
+ * variables. Instead, the lexer marks the tokens which contain
+ * EXPANSION_CHARACTER, so that only those tokens need to be examined when the
+ * command is executed. Likewise, tokens with wildcards which were not quoted
+ * are marked for pathname expansion. Within such a token, every quoted
+ * wildcard (and every GLOB_ESCAPE) is preceded by GLOB_ESCAPE, so that it
+ * only matches itself. A token without wildcards keeps no GLOB_ESCAPE.
+ *
+ * A command substitution is copied into the token unchanged (including its
+ * quotation marks, separators and operators), so that the command can be split
+ * into arguments of its own when it is executed.
+ */
+
+#include "../inc/lexer.h"
+
+unsigned char lexer_classes[256]; // the class of each character
+char lexer_special[LEX_MAX_SPECIAL]; // characters which are not LEX_WORD
+unsigned int lexer_num_special; // number of characters in lexer_special
+
+/*
+ * Build the character class table. This must be called once before any input
+ * is split into tokens.
+ */
+void lexer_setup(void) {
+    const char * c; // working pointer through SEPARATORS, QUOTATION_MARKS, OPERATORS and GLOB_CHARACTERS
+
+    memset(lexer_classes, LEX_WORD, sizeof(lexer_classes));
+    lexer_num_special = 0;
+
+    // A null character always separates arguments
+    lexer_classes[0] = LEX_SEPARATOR;
+    lexer_special[lexer_num_special++] = '\0';
+
+    for (c = SEPARATORS; *c && (lexer_num_special < LEX_MAX_SPECIAL); c++) {
+        lexer_classes[(unsigned char) *c] = LEX_SEPARATOR;
+        lexer_special[lexer_num_special++] = *c;
+    }
+    for (c = QUOTATION_MARKS; *c && (lexer_num_special < LEX_MAX_SPECIAL); c++) {
+        lexer_classes[(unsigned char) *c] = LEX_QUOTE;
+        lexer_special[lexer_num_special++] = *c;
+    }
+    for (c = OPERATORS; *c && (lexer_num_special < LEX_MAX_SPECIAL); c++) {
+        lexer_classes[(unsigned char) *c] = LEX_OPERATOR;
+        lexer_special[lexer_num_special++] = *c;
+    }
+    if (lexer_num_special < LEX_MAX_SPECIAL) {
+        lexer_classes[(unsigned char) EXPANSION_CHARACTER] = LEX_EXPANSION;
+        lexer_special[lexer_num_special++] = EXPANSION_CHARACTER;
+    }
+    for (c = GLOB_CHARACTERS; *c && (lexer_num_special < LEX_MAX_SPECIAL); c++) {
+        lexer_classes[(unsigned char) *c] = LEX_GLOB;
+        lexer_special[lexer_num_special++] = *c;
+    }
+    if (lexer_num_special < LEX_MAX_SPECIAL) {
+        lexer_classes[(unsigned char) GLOB_ESCAPE] = LEX_GLOB;
+        lexer_special[lexer_num_special++] = GLOB_ESCAPE;
+    }
+}
+
+/*
+ * Calculate the size of the token buffer required to split an input into
+ * tokens. Each token needs two bytes more than its length in the input, for its
+ * flags and its null character, and every token uses at least one character of
+ * the input (an operator may be a token of a single character). A character
+ * preceded by GLOB_ESCAPE needs two bytes, which still fits: a quoted wildcard
+ * also uses a quotation mark of the input, and the escapes of a token without
+ * wildcards are removed as soon as the token ends.
+ *
+ * PARAMETERS
+ *     length: The length of the input.
+ *
+ * RETURN VALUE
+ * The number of bytes required for the token buffer.
+ */
+size_t lexer_buffer_size(const size_t length) {
+    return (3 * length) + 2;
+}
+
+/*
+ * Prepare to split an input into tokens.
+ *
+ * PARAMETERS
+ *     lex: The lexer to prepare.
+ *     input: The input to split. This does not need to be null-terminated.
+ *     length: The length of the input.
+ *     buffer: The buffer to which tokens will be written. This MUST be at
+ *         least lexer_buffer_size(length) bytes long, and must remain valid
+ *         for as long as the tokens are used.
+ */
+void lexer_init(lexer * lex, const char * input, const size_t length, char * buffer) {
+    lex->input = input;
+    lex->end = input + length;
+    lex->output = buffer;
+}
+
+/*
+ * Get the next token from the input. Separators and operators between quotation
+ * marks are part of the token, and the quotation marks themselves are removed.
+ * An operator which is not quoted ends the current token, and is then returned
+ * as a token of its own.
+ *
+ * PARAMETERS
+ *     lex: The lexer.
+ *
+ * RETURN VALUE
+ * A pointer to the next null-terminated token, or null if there are no more
+ * tokens.
+ */
+char * lexer_next(lexer * lex) {
+    const char * p = lex->input; // the current character
+    const char * end = lex->end; // end of the input
+    char * token; // the token
+    char * flags; // the flags of the token
+    boolean quoted = FALSE; // is the current character between quotation marks?
+    boolean escaped = FALSE; // has a character of the token been preceded by GLOB_ESCAPE?
+    size_t run; // length of a run of LEX_WORD characters
+
+    // Skip separators before the token
+    while ((p < end) && (lexer_classes[(unsigned char) *p] == LEX_SEPARATOR)) {
+        p++;
+    }
+
+    if (p == end) {
+        lex->input = p;
+        return NULL;
+    }
+
+    flags = lex->output;
+    *flags = 0;
+    token = flags + 1;
+    lex->output = token;
+
+    while (p < end) {
+        switch (lexer_classes[(unsigned char) *p]) {
+            case LEX_WORD:
+                run = lexer_word_run(p, end);
+                memcpy(lex->output, p, run);
+                lex->output += run;
+                p += run;
+                continue;
+
+            case LEX_QUOTE:
+                quoted = !quoted;
+                *flags |= TOKEN_QUOTED;
+                p++;
+                continue;
+
+            case LEX_EXPANSION:
+                *flags |= TOKEN_EXPAND;
+                if ((run = lexer_substitution_length(p, end))) {
+                    memcpy(lex->output, p, run);
+                    lex->output += run;
+                    p += run;
+                    continue;
+                }
+                *lex->output++ = *p++;
+                continue;
+
+            case LEX_GLOB:
+                if (quoted || (*p == GLOB_ESCAPE)) {
+                    // A quoted wildcard only matches itself
+                    *lex->output++ = GLOB_ESCAPE;
+                    escaped = TRUE;
+                } else {
+                    *flags |= TOKEN_GLOB;
+                }
+                *lex->output++ = *p++;
+                continue;
+
+            case LEX_OPERATOR:
+                if (quoted) {
+                    *lex->output++ = *p++;
+                    continue;
+                }
+                if (lex->output == token) {
+                    *lex->output++ = *p++;
+                }
+                break;
+
+            default: // LEX_SEPARATOR
+                if (quoted) {
+                    *lex->output++ = *p++;
+                    continue;
+                }
+        }
+        break;
+    }
+
+    *lex->output++ = '\0';
+    lex->input = p;
+
+    // The escapes are only needed by a pathname pattern
+    if (escaped && !(*flags & TOKEN_GLOB)) {
+        lex->output = token + remove_escapes(token) + 1 /* for null character */;
+    }
+
+    return token;
+}
+
+/*
+ * Find the length of a run of LEX_WORD characters.
+ *
+ * PARAMETERS
+ *     start: The first character of the run.
+ *     end: End of the input.
+ *
+ * RETURN VALUE
+ * The number of consecutive LEX_WORD characters starting at start.
+ */
+size_t lexer_word_run(const char * start, const char * end) {
+    const char * p = start; // the current character
+
+#ifdef __SSE2__
+    while (end - p >= 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) p); // the next sixteen characters
+        __m128i matches = _mm_setzero_si128(); // bytes which are not LEX_WORD characters
+        int mask; // one bit for each byte in matches
+
+        for (unsigned int i = 0; i < lexer_num_special; ++i) {
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(lexer_special[i])));
+        }
+
+        if ((mask = _mm_movemask_epi8(matches))) {
+            return (size_t) (p - start) + (size_t) __builtin_ctz((unsigned int) mask);
+        }
+        p += 16;
+    }
+#endif // #ifdef __SSE2__
+
+    while ((p < end) && (lexer_classes[(unsigned char) *p] == LEX_WORD)) {
+        p++;
+    }
+
+    return (size_t) (p - start);
+}
+
+/*
+ * Find the length of a command substitution: EXPANSION_CHARACTER and
+ * SUBSTITUTION_OPEN, followed by a command and the matching SUBSTITUTION_CLOSE.
+ * Nested command substitutions are skipped, as are SUBSTITUTION_OPEN and
+ * SUBSTITUTION_CLOSE between quotation marks.
+ *
+ * PARAMETERS
+ *     start: The EXPANSION_CHARACTER which may start a command substitution.
+ *     end: End of the input.
+ *
+ * RETURN VALUE
+ * The length of the command substitution (including EXPANSION_CHARACTER,
+ * SUBSTITUTION_OPEN and SUBSTITUTION_CLOSE), or 0 if start is not followed by
+ * SUBSTITUTION_OPEN or there is no matching SUBSTITUTION_CLOSE.
+ */
+size_t lexer_substitution_length(const char * start, const char * end) {
+    const char * p = start + 2; // the current character
+    unsigned int depth = 1; // number of SUBSTITUTION_OPEN characters which have not been closed
+    boolean quoted = FALSE; // is the current character between quotation marks?
+
+    if ((end - start < 2) || (start[1] != SUBSTITUTION_OPEN)) {
+        return 0;
+    }
+
+    for (; p < end; p++) {
+        if (lexer_classes[(unsigned char) *p] == LEX_QUOTE) {
+            quoted = !quoted;
+        } else if (quoted) {
+            continue;
+        } else if (*p == SUBSTITUTION_OPEN) {
+            depth++;
+        } else if ((*p == SUBSTITUTION_CLOSE) && !--depth) {
+            return (size_t) (p + 1 - start);
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Check whether a token contained no quotation marks. Special characters (such
+ * as the pipe character) are only recognised if they were not quoted.
+ *
+ * PARAMETERS
+ *     token: A token returned by lexer_next.
+ *
+ * RETURN VALUE
+ * TRUE if the token contained no quotation marks, otherwise FALSE.
+ */
+boolean is_unquoted(const char * token) {
+    return !(token[-1] & TOKEN_QUOTED);
+}
+
+/*
+ * Remove the GLOB_ESCAPE characters from a pathname pattern, leaving the
+ * characters which they escaped.
+ *
+ * PARAMETERS
+ *     pattern: The null-terminated pattern, which is changed in place.
+ *
+ * RETURN VALUE
+ * The length of the pattern without the GLOB_ESCAPE characters.
+ */
+size_t remove_escapes(char * pattern) {
+    char * q = pattern; // next character of the result
+
+    for (const char * p = pattern; *p; p++) {
+        if ((*p == GLOB_ESCAPE) && p[1]) {
+            p++;
+        }
+        *q++ = *p;
+    }
+    *q = '\0';
+
+    return (size_t) (q - pattern);
+}
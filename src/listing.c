@@ -0,0 +1,383 @@
+/*
+ * listing.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to produce a long directory listing
+ * (in the same format as 'ls -al') without executing another program.
+ *
+ * Directory entries are read in large blocks with getdents64, and information
+ * about every entry is then gathered in a single pass with statx (relative to
+ * the directory, requesting only the fields which are displayed). The listing
+ * is formatted into the writer of the command (see writer.c), so that it is
+ * usually output with a single write together with the rest of the output.
+ */
+
+#include "../inc/listing.h"
+
+/*
+ * Write a long listing of a directory to a writer. If the path does not refer
+ * to a directory, then only the file itself is listed.
+ *
+ * PARAMETERS
+ *     directory: The path of the directory to list. If null, then the current
+ *         working directory is listed.
+ *     out: The writer to which the listing is written.
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned and errno is set to indicate the
+ * error.
+ */
+int write_directory_listing(const char * directory, writer * out) {
+    int dir_fd; // file descriptor of the directory
+    listing_entry * entries; // the entries to be listed
+    unsigned int count; // number of entries
+    char * names = NULL; // storage for the names of the entries
+    int widths[4] = {0, 0, 0, 0}; // width of the link count, user, group and size columns
+    unsigned long long blocks = 0; // total number of 512 byte blocks used by the entries
+    char field[32]; // a formatted number, used to calculate column widths
+    const time_t now = time(NULL); // the current time
+    int length; // length of a column
+    int error = 0; // error number to report
+
+    if (!directory) {
+        directory = ".";
+    }
+
+    if ((dir_fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) >= 0) {
+        // Read the directory
+        if (listing_read_entries(dir_fd, &entries, &count, &names)) {
+            error = errno;
+            close(dir_fd);
+            errno = error;
+            return -1;
+        }
+        listing_stat_entries(dir_fd, entries, count);
+        close(dir_fd);
+
+        // Sort the entries by name
+        qsort(entries, count, sizeof(listing_entry), listing_compare);
+    } else if (errno == ENOTDIR) {
+        // List the file itself
+        count = 1;
+        if (!(entries = (listing_entry *) malloc(sizeof(listing_entry)))) sys_err("malloc"); // attempt to allocate memory for entries
+        entries->name = (char *) directory;
+        listing_stat_entries(AT_FDCWD, entries, count);
+
+        if (!entries->info.stx_mask) {
+            error = errno;
+            free(entries);
+            errno = error;
+            return -1;
+        }
+    } else {
+        return -1;
+    }
+
+    // Calculate the column widths
+    for (unsigned int i = 0; i < count; ++i) {
+        if (!entries[i].info.stx_mask) {
+            continue;
+        }
+
+        blocks += entries[i].info.stx_blocks;
+
+        if ((length = snprintf(field, sizeof(field), "%u", entries[i].info.stx_nlink)) > widths[0]) {
+            widths[0] = length;
+        }
+        if ((length = (int) strlen(listing_user_name(entries[i].info.stx_uid))) > widths[1]) {
+            widths[1] = length;
+        }
+        if ((length = (int) strlen(listing_group_name(entries[i].info.stx_gid))) > widths[2]) {
+            widths[2] = length;
+        }
+        if (S_ISCHR(entries[i].info.stx_mode) || S_ISBLK(entries[i].info.stx_mode)) {
+            length = snprintf(field, sizeof(field), "%u, %u", entries[i].info.stx_rdev_major, entries[i].info.stx_rdev_minor);
+        } else {
+            length = snprintf(field, sizeof(field), "%llu", (unsigned long long) entries[i].info.stx_size);
+        }
+        if (length > widths[3]) {
+            widths[3] = length;
+        }
+    }
+
+    // Format the listing (block counts are reported in units of 1024 bytes)
+    if ((dir_fd >= 0) && writer_printf(out, "total %llu\n", (blocks + 1) / 2)) {
+        error = errno;
+    }
+    for (unsigned int i = 0; (i < count) && !error; ++i) {
+        if (listing_format_entry(out, &entries[i], widths, now)) {
+            error = errno;
+        }
+    }
+
+    // Clean up
+    for (unsigned int i = 0; i < count; ++i) {
+        free(entries[i].link);
+    }
+    free(entries);
+    free(names);
+
+    errno = error;
+    return error ? -1 : 0;
+}
+
+/*
+ * Read the names of all entries in a directory.
+ *
+ * The memory allocated by this function must be freed by the caller (both the
+ * returned array and names).
+ *
+ * PARAMETERS
+ *     dir_fd: File descriptor of the directory.
+ *     result: Set to a pointer to an array of entries.
+ *     count: Set to the number of entries read.
+ *     names: Set to a pointer to the storage containing the names of all
+ *         entries.
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned, errno is set to indicate the error
+ * and nothing needs to be freed.
+ */
+int listing_read_entries(const int dir_fd, listing_entry ** result, unsigned int * count, char ** names) {
+    char dents[LISTING_DENTS_SIZE]; // buffer for getdents64
+    ssize_t bytes; // number of bytes read by getdents64
+    struct dirent64 * dent; // the current directory entry
+    size_t size = 0; // current size of names
+    size_t length = 0; // number of characters used in names
+    size_t name_length; // length of the current name
+    unsigned int capacity = 0; // current capacity of entries
+    listing_entry * entries = NULL; // the entries read
+    char * name; // working pointer through names
+    int error; // error number reported by getdents64
+
+    *result = NULL;
+    *count = 0;
+    *names = NULL;
+
+    while ((bytes = getdents64(dir_fd, dents, sizeof(dents))) > 0) {
+        for (ssize_t offset = 0; offset < bytes; offset += dent->d_reclen) {
+            dent = (struct dirent64 *) (dents + offset);
+            name_length = strlen(dent->d_name) + 1 /* for null character */;
+
+            // Memory allocation
+            if (length + name_length > size) {
+                size = (size + name_length) * 2;
+                if (!(*names = (char *) realloc(*names, size))) sys_err("realloc"); // attempt to reallocate memory for names
+            }
+            if (*count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                if (!(entries = (listing_entry *) realloc(entries, (size_t) (capacity * sizeof(listing_entry))))) sys_err("realloc"); // attempt to reallocate memory for entries
+            }
+
+            memcpy(*names + length, dent->d_name, name_length);
+            length += name_length;
+            (*count)++;
+        }
+    }
+
+    if (bytes < 0) {
+        // The directory could not be read completely
+        error = errno;
+        free(entries);
+        free(*names);
+        *count = 0;
+        *names = NULL;
+        errno = error;
+        return -1;
+    }
+
+    // The names are stored consecutively, in the same order as the entries
+    name = *names;
+    for (unsigned int i = 0; i < *count; ++i) {
+        entries[i].name = name;
+        entries[i].link = NULL;
+        name += strlen(name) + 1 /* for null character */;
+    }
+
+    *result = entries;
+    return 0;
+}
+
+/*
+ * Get information about each entry in a directory. If information about an
+ * entry cannot be retrieved, then the mask of that entry is set to zero.
+ *
+ * PARAMETERS
+ *     dir_fd: File descriptor of the directory containing the entries.
+ *     entries: The entries.
+ *     count: The number of entries.
+ */
+void listing_stat_entries(const int dir_fd, listing_entry * entries, const unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i) {
+        entries[i].link = NULL;
+
+        if (statx(dir_fd, entries[i].name, AT_SYMLINK_NOFOLLOW, LISTING_STATX_MASK, &entries[i].info)) {
+            entries[i].info.stx_mask = 0;
+            continue;
+        }
+
+        // Find the target of symbolic links
+        if (S_ISLNK(entries[i].info.stx_mode)) {
+            ssize_t length; // length of the target
+
+            // Memory allocation
+            if (!(entries[i].link = (char *) malloc((size_t) ((entries[i].info.stx_size + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for link
+
+            if ((length = readlinkat(dir_fd, entries[i].name, entries[i].link, (size_t) entries[i].info.stx_size)) < 0) {
+                length = 0;
+            }
+            entries[i].link[length] = '\0';
+        }
+    }
+}
+
+/*
+ * Compare the names of two listing entries (for qsort).
+ *
+ * PARAMETERS
+ *     a: Pointer to the first entry.
+ *     b: Pointer to the second entry.
+ *
+ * RETURN VALUE
+ * An integer less than, equal to, or greater than zero if the name of the
+ * first entry is less than, equal to, or greater than the name of the second.
+ */
+int listing_compare(const void * a, const void * b) {
+    return strcoll(((const listing_entry *) a)->name, ((const listing_entry *) b)->name);
+}
+
+/*
+ * Format a single entry of a long listing.
+ *
+ * PARAMETERS
+ *     out: The writer to which the entry is written.
+ *     entry: The entry to format.
+ *     widths: The width of the link count, user, group and size columns.
+ *     now: The current time.
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned and errno is set to indicate the
+ * error.
+ */
+int listing_format_entry(writer * out, const listing_entry * entry, const int * widths, const time_t now) {
+    const struct statx * info = &entry->info; // information about the entry
+    char mode[11]; // the file type and permissions
+    char size[32]; // the file size (or device numbers)
+    char date[32]; // the modification time
+    const time_t mtime = (time_t) info->stx_mtime.tv_sec; // the modification time
+    struct tm local; // the modification time in the local time zone
+
+    if (!info->stx_mask) {
+        // Information about the entry could not be retrieved
+        return writer_printf(out, "?????????? %*s %-*s %-*s %*s %12s %s\n", widths[0], "?", widths[1], "?", widths[2], "?", widths[3], "?", "?", entry->name);
+    }
+
+    // File type
+    switch (info->stx_mode & S_IFMT) {
+        case S_IFDIR:  mode[0] = 'd'; break;
+        case S_IFLNK:  mode[0] = 'l'; break;
+        case S_IFCHR:  mode[0] = 'c'; break;
+        case S_IFBLK:  mode[0] = 'b'; break;
+        case S_IFIFO:  mode[0] = 'p'; break;
+        case S_IFSOCK: mode[0] = 's'; break;
+        default:       mode[0] = '-'; break;
+    }
+
+    // Permissions
+    mode[1] = (info->stx_mode & S_IRUSR) ? 'r' : '-';
+    mode[2] = (info->stx_mode & S_IWUSR) ? 'w' : '-';
+    mode[3] = (info->stx_mode & S_ISUID) ? ((info->stx_mode & S_IXUSR) ? 's' : 'S') : ((info->stx_mode & S_IXUSR) ? 'x' : '-');
+    mode[4] = (info->stx_mode & S_IRGRP) ? 'r' : '-';
+    mode[5] = (info->stx_mode & S_IWGRP) ? 'w' : '-';
+    mode[6] = (info->stx_mode & S_ISGID) ? ((info->stx_mode & S_IXGRP) ? 's' : 'S') : ((info->stx_mode & S_IXGRP) ? 'x' : '-');
+    mode[7] = (info->stx_mode & S_IROTH) ? 'r' : '-';
+    mode[8] = (info->stx_mode & S_IWOTH) ? 'w' : '-';
+    mode[9] = (info->stx_mode & S_ISVTX) ? ((info->stx_mode & S_IXOTH) ? 't' : 'T') : ((info->stx_mode & S_IXOTH) ? 'x' : '-');
+    mode[10] = '\0';
+
+    // Size (or device numbers)
+    if (S_ISCHR(info->stx_mode) || S_ISBLK(info->stx_mode)) {
+        snprintf(size, sizeof(size), "%u, %u", info->stx_rdev_major, info->stx_rdev_minor);
+    } else {
+        snprintf(size, sizeof(size), "%llu", (unsigned long long) info->stx_size);
+    }
+
+    // Modification time (the year is shown instead of the time for old or future files)
+    localtime_r(&mtime, &local);
+    if ((mtime > now) || (now - mtime > LISTING_RECENT_SECONDS)) {
+        strftime(date, sizeof(date), "%b %e  %Y", &local);
+    } else {
+        strftime(date, sizeof(date), "%b %e %H:%M", &local);
+    }
+
+    if (writer_printf(out, "%s %*u %-*s ", mode, widths[0], info->stx_nlink, widths[1], listing_user_name(info->stx_uid))) {
+        return -1;
+    }
+    if (writer_printf(out, "%-*s %*s %s %s", widths[2], listing_group_name(info->stx_gid), widths[3], size, date, entry->name)) {
+        return -1;
+    }
+    if (entry->link && writer_printf(out, " -> %s", entry->link)) {
+        return -1;
+    }
+    return writer_puts(out, "\n");
+}
+
+/*
+ * Get the name of a user. The most recent result is remembered, as most
+ * entries in a directory usually have the same owner.
+ *
+ * PARAMETERS
+ *     uid: The user ID.
+ *
+ * RETURN VALUE
+ * A pointer to a null-terminated string containing the name of the user (or
+ * the user ID if the user has no name). This string is overwritten by the
+ * next call to this function.
+ */
+const char * listing_user_name(const uid_t uid) {
+    static uid_t cached_uid = (uid_t) -1; // the user ID of the most recent result
+    static char name[64]; // the most recent result
+    struct passwd * pw; // the password database entry of the user
+
+    if (uid != cached_uid) {
+        if ((pw = getpwuid(uid))) {
+            snprintf(name, sizeof(name), "%s", pw->pw_name);
+        } else {
+            snprintf(name, sizeof(name), "%u", (unsigned int) uid);
+        }
+        cached_uid = uid;
+    }
+
+    return name;
+}
+
+/*
+ * Get the name of a group. The most recent result is remembered, as most
+ * entries in a directory usually have the same group.
+ *
+ * PARAMETERS
+ *     gid: The group ID.
+ *
+ * RETURN VALUE
+ * A pointer to a null-terminated string containing the name of the group (or
+ * the group ID if the group has no name). This string is overwritten by the
+ * next call to this function.
+ */
+const char * listing_group_name(const gid_t gid) {
+    static gid_t cached_gid = (gid_t) -1; // the group ID of the most recent result
+    static char name[64]; // the most recent result
+    struct group * gr; // the group database entry of the group
+
+    if (gid != cached_gid) {
+        if ((gr = getgrgid(gid))) {
+            snprintf(name, sizeof(name), "%s", gr->gr_name);
+        } else {
+            snprintf(name, sizeof(name), "%u", (unsigned int) gid);
+        }
+        cached_gid = gid;
+    }
+
+    return name;
+}
@@ -1,1239 +1,1645 @@
-/*
- * myshell.c
- *
- * Author: Joshua Spence
- * SID:    308216350
- */
-
-#include "../inc/myshell.h"
-
-process_information proc_info; // information about child processes
-FILE * input_redir; // file for input (stdin if null)
-FILE * output_redir; // file for output (stdout if null)
-char * path; // path to the executable
-#ifdef DEBUG
-
-boolean debug; // is debug mode on?
-#endif // #ifdef DEBUG
-
-/*
- * Runs the 'myshell' shell.
- *
- * PARAMETERS
- *     argc: Number of arguments.
- *     argv: Pointer to argument array.
- *
- * RETURN VALUE
- * 0 on success.
- */
-int main(int argc, char ** argv) {
-    FILE * input; // the source of the command inputs
-    boolean display_prompt; // should the prompt be displayed?
-
-    char * input_buffer = NULL; // line buffer
-    char * args[MAX_ARGS]; // pointers to argument strings
-    char ** arg; // working pointer through arguments
-    unsigned int num_args; // number of arguments entered into prompt
-
-    int return_val; // return value of last internal command call
-
-    char * cwd; // current working directory
-
-    signal(SIGINT, SIG_IGN); // disable SIGINT to prevent shell from terminating with Ctrl+C
-    signal(SIGCHLD, SIG_IGN); // prevent zombie children
-
-    // Check for batch file input
-    if (argc > 1) {
-        if (argc > 2) {
-        // Too many arguments were entered
-            err("Too many arguments were specified. Some arguments will be ignored.");
-        }
-
-        if (argv[1]) {
-            // Batch file was specified
-#ifdef DEBUG
-            if (debug) {
-                const char msg[] = "Input batch file '%s' was specified. Input commands will be parsed from this file.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(argv[1]) + 1 /* null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, msg, argv[1]);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            if (!(input = fopen(argv[1], "r"))) sys_err("fopen"); // attempt to open the input batch file
-            display_prompt = FALSE; // don't display a prompt when reading input from a file
-        } else {
-#ifdef DEBUG
-            if (debug) {
-                debug_message("No input batch file was specified. Input commands will be parsed from stdin.");
-            }
-
-#endif // #ifdef DEBUG
-            input = stdin;
-            display_prompt = TRUE;
-        }
-    } else {
-        input = stdin;
-        display_prompt = TRUE;
-    }
-
-    // Get home directory
-    const char const * home = getcwd(NULL, (size_t) 0); // getcwd will dynamically allocate memory for home
-    cwd = getcwd(NULL, (size_t) 0); // getcwd will dynamically allocate memory for cwd
-
-    // Get path to executable and add it to the environment variables
-    path = get_path(NULL); // get path to the executable
-    if (setenv("shell", path, 1)) sys_err("setenv"); // set the 'shell' environment variable to the path to the shell, overwriting any existing value
-
-    // Keep reading input until "quit" command or EOF of stdin/redirected input
-    while (!feof(input)) {
-        reset_process_information();
-
-        // Getting current working directory
-        free(cwd);
-        cwd = getcwd(NULL, (size_t) 0); // getcwd will dynamically allocate memory for cwd
-
-        // Output shell prompt if required
-        if (display_prompt) {
-                output_shell_prompt(cwd);
-        }
-
-        // Get input from stdin/batch file
-        input_buffer = get_input(input_buffer, input);
-
-#ifdef DEBUG
-        if (debug) {
-            debug_read_line_message(input_buffer);
-        }
-
-#endif // #ifdef DEBUG
-        // Tokenize the input into args array
-#ifdef DEBUG
-        if (debug) {
-            debug_message("Tokenizing input into array of arguments.");
-        }
-
-#endif // #ifdef DEBUG
-        arg = args;
-        *arg++ = quoted_strtok(input_buffer, SEPARATORS, QUOTATION_MARKS);
-        while ((*arg++ = quoted_strtok(NULL, SEPARATORS, QUOTATION_MARKS)));
-        arg = args; // point the arg variable back to the start of the arguments
-
-        // Remove quotation marks from arguments
-#ifdef DEBUG
-        if (debug) {
-            debug_message("Removing quotation marks from arguments.");
-        }
-
-#endif // #ifdef DEBUG
-        while (*arg) {
-            remove_character(*arg++, '\"');
-        }
-        arg = args; // point the arg variable back to the start of the arguments
-
-        // Count the number of arguments
-        num_args = 0;
-        while (*arg++) {
-            num_args++;
-        }
-        arg = args; // point the arg variable back to the start of the arguments
-
-#ifdef DEBUG
-        if(debug) {
-            const char msg[] = "Tokenized input into %d arguments.";
-            char * dbg_msg;
-
-            // Memory allocation
-            if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + digits(num_args) + 1 /* null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-            // Output debug message
-            sprintf(dbg_msg, msg, num_args);
-            debug_message(dbg_msg);
-
-            // Clean up
-            free(dbg_msg);
-        }
-
-#endif // #ifdef DEBUG
-        check_for_dont_wait(args);
-        check_for_input_redirection(args);
-        check_for_output_redirection(args);
-
-        // If anything was input, execute the commands
-        if (*arg) {
-#ifdef DEBUG
-            if (debug) {
-                debug_command_args_message(input_buffer, (const char **) args);
-            }
-
-            // Check for debug mode change
-            if (!strcmp(*arg, DEBUG_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-
-                // Check for arguments
-                if (*arg) {
-                    // Check for valid arguments
-                    if (!strcmp(*arg, DEBUG_ON)) {
-                        arg++; // increment argument pointer as an argument has been used
-
-                        // Turn debug mode on
-                        return_val = debug_mode(TRUE);
-                    } else if(!strcmp(*arg, DEBUG_OFF)) {
-                        arg++; // increment argument pointer as an argument has been used
-
-                        // Turn debug mode off
-                        return_val = debug_mode(FALSE);
-                    } else {
-                        error_unrecognised_argument(args[0], args[1]);
-                    }
-                } else {
-                    error_no_argument(args[0]);
-                }
-            }
-            else
-#endif // #ifdef DEBUG
-        // Check for internal commands
-            // "clear" command
-            if (!strcmp(*arg, CLEAR_SCREEN_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-#ifdef DEBUG
-                if (debug) {
-                    debug_command_recognised_message(args[0], CLEAR_SCREEN_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-
-                return_val = clear_screen();
-#ifdef DEBUG
-
-                if (debug) {
-                    debug_command_executed_message(args[0], CLEAR_SCREEN_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-            }
-
-            // "dir" command
-            else if (!strcmp(*arg, LIST_DIRECTORY_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-#ifdef DEBUG
-                if (debug) {
-                    debug_command_recognised_message(args[0], LIST_DIRECTORY_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-
-                return_val = list_directory(*arg++ /* increment argument pointer as an argument has been used */);
-#ifdef DEBUG
-
-                if (debug) {
-                    debug_command_executed_message(args[0], LIST_DIRECTORY_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-            }
-
-            // "environ" command
-            else if (!strcmp(*arg, PRINT_ENVIRONMENT_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-#ifdef DEBUG
-                if (debug) {
-                    debug_command_recognised_message(args[0], PRINT_ENVIRONMENT_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-
-                return_val = print_environment();
-#ifdef DEBUG
-
-                if (debug) {
-                    debug_command_executed_message(args[0], PRINT_ENVIRONMENT_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-            }
-
-            // "cd" command
-            else if (!strcmp(*arg, CHANGE_DIRECTORY_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-#ifdef DEBUG
-                if (debug) {
-                    debug_command_recognised_message(args[0], CHANGE_DIRECTORY_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-
-                return_val = change_directory(*arg++ /* increment argument pointer as an argument has been used */);
-#ifdef DEBUG
-
-                if (debug) {
-                        debug_command_executed_message(args[0], CHANGE_DIRECTORY_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-            }
-
-            // "echo" command
-            else if (!strcmp(*arg, ECHO_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-#ifdef DEBUG
-                if (debug) {
-                    debug_command_recognised_message(args[0], ECHO_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-
-                return_val = echo((const char **) arg);
-
-                while(*arg++); // increment argument pointer as all arguments have been used
-#ifdef DEBUG
-
-                if (debug) {
-                    debug_command_executed_message(args[0], ECHO_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-            }
-
-            // "help" command
-            else if (!strcmp(*arg, HELP_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-#ifdef DEBUG
-                if (debug) {
-                    debug_command_recognised_message(args[0], HELP_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-
-                return_val = help(home);
-#ifdef DEBUG
-
-                if (debug) {
-                    debug_command_executed_message(args[0], HELP_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-            }
-
-            // "pause" command
-            else if (!strcmp(*arg, PAUSE_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-#ifdef DEBUG
-                if (debug) {
-                    debug_command_recognised_message(args[0], PAUSE_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-
-                return_val = pause();
-#ifdef DEBUG
-
-                if (debug) {
-                    debug_command_executed_message(args[0], PAUSE_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-            }
-
-            // "quit" command
-            else if (!strcmp(*arg, QUIT_COMMAND)) {
-                arg++; // increment argument pointer as an argument has been used
-#ifdef DEBUG
-                if (debug) {
-                    debug_command_recognised_message(args[0], QUIT_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-
-                return_val = quit();
-#ifdef DEBUG
-
-                if (debug) {
-                    debug_command_executed_message(args[0], QUIT_CMD_NAME);
-                }
-#endif // #ifdef DEBUG
-            }
-
-            // Else pass command to external shell
-            else {
-#ifdef DEBUG
-                if (debug) {
-                    // Create debug message
-                    const char msg[] = "Command '%s' not recognised internally, passing to system shell.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(*arg) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, *arg);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-
-                return_val = process_external_command(arg);
-            }
-        }
-
-        // Close input file
-        if (input_redir) {
-#ifdef DEBUG
-            if (debug) {
-                debug_message("Closing input file.");
-            }
-
-#endif // #ifdef DEBUG
-            if (fclose(input_redir)) sys_err("fclose"); // attempt to close the input file
-            input_redir = NULL;
-#ifdef DEBUG
-
-            if (debug) {
-                debug_message("Closed input file.");
-            }
-
-#endif // #ifdef DEBUG
-                }
-
-                // Close output file if necessary
-        if (output_redir) {
-#ifdef DEBUG
-            if (debug) {
-                debug_message("Closing output file.");
-            }
-
-#endif // #ifdef DEBUG
-            if (fclose(output_redir)) sys_err("fclose"); // attempt to close the output file
-            output_redir = NULL;
-#ifdef DEBUG
-
-            if (debug) {
-                debug_message("Closed ouput file.");
-            }
-
-#endif // #ifdef DEBUG
-                }
-
-                // Check if the shell should quit
-        if (return_val == EXIT_STATUS_QUIT) {
-                break;
-        }
-    }
-
-    // Clean up
-    if (fclose(input)) sys_err("fclose"); // attempt to close the input batch file
-    input = NULL;
-    free((void *) home); // free the memory dynamically allocated by getcwd
-    free(cwd); // free the memory dynamically allocated by getcwd
-    free(path); // free the memory dynamically allocated by get_path
-    free(input_buffer); // free the memory dynamically allocated by get_input
-
-    return 0;
-}
-
-/*
- * This function outputs to the terminal a prompt indicating that the shell is
- * waiting for user input.
- *
- * PARAMETERS
- *     path: A null-terminated string containing the path that will appear in
- *         the shell prompt.
- */
-void output_shell_prompt(const char * path) {
-    char * prompt; // the shell prompt to display
-
-    // Allocate space for shell prompt
-#ifdef DEBUG
-    if (!(prompt = (char *) malloc((size_t) ((strlen(DEBUG_PROMPT) + strlen(path) + strlen(PROMPT_SUFFIX) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for prompt
-#else
-    if (!(prompt = (char *) malloc((size_t) ((strlen(path) + strlen(PROMPT_SUFFIX) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for prompt
-#endif // #ifdef DEBUG
-
-    // Generate the shell prompt
-#ifdef DEBUG
-    if (debug) {
-        sprintf(prompt, "%s%s%s", DEBUG_PROMPT, path, PROMPT_SUFFIX);
-    } else {
-        sprintf(prompt, "%s%s", path, PROMPT_SUFFIX);
-    }
-#else
-    sprintf(prompt, "%s%s", path, PROMPT_SUFFIX);
-#endif // #ifdef DEBUG
-
-    // Write prompt
-    printf("%s", prompt);
-
-    // Clean up
-    free(prompt);
-}
-
-/*
- * This function passes an unrecognised command to the system for processing.
- *
- * PARAMETERS
- *     args: A pointer to an array of character strings. MUST be terminated by a
- *         null entry.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int process_external_command(char ** args) {
-    // Fork the current process
-    switch(proc_info.pid = fork()) {
-        case -1: // fork failed
-            sys_err("fork");
-            break;
-
-        case 0: // child
-#ifdef DEBUG
-            if (debug) {
-                debug_message("Setting 'parent' environment variable in child process.");
-            }
-
-#endif // #ifdef DEBUG
-            // Set environment variable
-            if (setenv("parent", path, 1)) sys_err("setenv"); // set the 'parent' environment variable to the path to the shell, overwriting any existing value
-
-#ifdef DEBUG
-            if (debug) {
-                // Create debug message
-                const char msg[] = "Attempting to execute '%s' in child process.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(*args) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, msg, *args);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            // Redirect input if necessary
-            if (input_redir) {
-                dup2(fileno(input_redir), STDIN_FILENO);
-            }
-
-            // Redirect output if necessary
-            if (output_redir) {
-                dup2(fileno(output_redir), STDOUT_FILENO);
-            }
-
-            // Execute the command with the appropriate arguments
-            execvp(*args, args);
-
-            // If execution reaches this line, an error has occured as execvp should never return
-            const char msg[] = "execvp [%s]";
-            char * err_msg;
-
-            // Memory allocation
-            if (!(err_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(*args) + 1 /* null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-            // Output error message
-            sprintf(err_msg, msg, *args);
-            sys_err(err_msg);
-
-            // Clean up
-            free(err_msg);
-
-            break;
-
-        default: // parent
-            if (!proc_info.dont_wait) {
-#ifdef DEBUG
-                if (debug) {
-                    // Create debug message
-                    const char msg[] = "Parent process waiting for child process [PID: %d] to return.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + digits(proc_info.pid) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, proc_info.pid);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                // Wait for the child process to return
-                waitpid(proc_info.pid, &proc_info.status, WUNTRACED);
-#ifdef DEBUG
-
-                if (debug) {
-                    // Create debug message
-                    const char msg[] = "Child process %d has returned with status: %d.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + digits(proc_info.pid) + digits(proc_info.status) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, proc_info.pid, proc_info.status);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-#endif // #ifdef DEBUG
-            }
-#ifdef DEBUG
-            else {
-                if (debug) {
-                    // Create debug message
-                    const char msg[] = "Parent process continuing without waiting for child process [PID: %d] to return.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + digits(proc_info.pid) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, proc_info.pid);
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-            }
-#endif // #ifdef DEBUG
-    }
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * This function gets input from the user. It allocates and reallocates memory
- * for the input_buffer if the current input_buffer is not large enough.
- *
- * The memory allocated by this function must be freed by the caller.
- *
- * PARAMETERS
- *     input_buffer: A buffer in which the input will be stored. This can be
- *         null.
- *
- * RETURN VALUE
- * A pointer to a null-terminated string containing the input.
- */
-char * get_input(char * input_buffer, FILE * input) {
-    size_t size = 0; // current size of input_buffer
-    size_t length = 0; // number of characters in input_buffer
-
-    // Keep getting input using fgets until the input_buffer is large enough
-    do {
-        size += ALLOCATION_BLOCK;
-        if (!(input_buffer = (char *) realloc(input_buffer, size))) sys_err("realloc"); // realloc(NULL,n) is the same as malloc(n)
-
-        // Actually do the read. Note that fgets puts a terminal '\0' on the end of the string, so we make sure we overwrite this
-        fgets(input_buffer + length, size - length, input);
-
-        length = strlen(input_buffer);
-    } while (!feof(input) && !strchr(input_buffer, '\n'));
-
-    return input_buffer;
-}
-
-
-/*
- * This function and look at the last argument for the don't wait character
- * (defined in strings.h). Upon finding the don't wait character, the function
- * will set a flag and set this argument to NULL.
- *
- * Note that the don't wait character should be the last argument of the
- * argument array. No check is made for this, but all arguments after the don't
- * wait character will be ignored.
- *
- * PARAMETERS
- *     args: A pointer to an array of character strings. MUST be terminated by a
- *         null element.
-*/
-void check_for_dont_wait(char ** args) {
-    char ** arg = args; // working pointer through args
-    unsigned int count_args = 0; // number of arguments
-
-    // Count arguments
-    while (*arg++) {
-        count_args++;
-    }
-
-    // arg now points to the element AFTER the last null element
-
-    if (count_args >= 1) {
-        arg = arg - 2; // point arg to the last argument of the array
-
-#ifdef DEBUG
-        if (debug) {
-            // Create debug message
-            const char msg[] = "Checking for don't wait character '%c'.";
-            char * dbg_msg;
-
-            // Memory allocation
-            if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for dont wait character */ + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-            // Output debug message
-            sprintf(dbg_msg, msg, DONT_WAIT_CHARACTER);
-            debug_message(dbg_msg);
-
-            // Clean up
-            free(dbg_msg);
-        }
-
-#endif // #ifdef DEBUG
-        // Check for dont_wait character
-        if ((strlen(*arg) == 1) && ((*arg)[0] == DONT_WAIT_CHARACTER)) {
-#ifdef DEBUG
-            if (debug) {
-                // Create debug message
-                const char msg[] = "Found the character '%c'. This command will be executed in the background.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for dont wait character */ + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, msg, DONT_WAIT_CHARACTER);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            proc_info.dont_wait = TRUE; // set the don't wait flag
-
-#ifdef DEBUG
-            if (debug) {
-                // Create debug message
-                const char msg[] = "Removing '%c' from argument list.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for dont wait character */ + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, msg, DONT_WAIT_CHARACTER);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            // Remove argument from array
-            *(array_movetoend(arg)) = 0;
-        }
-    }
-#ifdef DEBUG
-    else {
-        // Not enough arguments
-        if (debug) {
-            debug_message("Not enough arguments for there to be a don't wait character. Skipping this check.");
-        }
-    }
-#endif // #ifdef DEBUG
-}
-
-/*
- * This function loops through the argument array and looks for the input
- * redirection character (defined in strings.h) and input redirection file. Upon
- * finding these arguments, the function will set a flag and set these argument
- * to NULL.
- *
- * Note that the don't wait character should be the last argument of the
- * argument array. No check is made for this, but all arguments after the don't
- * wait character will be ignored.
- *
- * PARAMETERS
- *     args: A pointer to an array of character strings. MUST be terminated by a
- *        null element.
-*/
-void check_for_input_redirection(char ** args) {
-    char ** arg = args; // working pointer through arguments
-
-#ifdef DEBUG
-    if(debug) {
-        // Create debug message
-        const char msg[] = "Checking for input redirection character '%c'.";
-        char * dbg_msg;
-
-        // Memory allocation
-        if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for input redirection character */ + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-        // Output debug message
-        sprintf(dbg_msg, msg, INPUT_REDIRECTION_CHAR);
-        debug_message(dbg_msg);
-
-        // Clean up
-        free(dbg_msg);
-    }
-
-#endif // #ifdef DEBUG
-    // Look for input redirection character
-    while (*arg) {
-        if ((strlen(*arg) == 1) && ((*arg)[0] == INPUT_REDIRECTION_CHAR)) {
-        // Input redirection has been specified
-#ifdef DEBUG
-            if (debug) {
-                // Create debug message
-                const char msg[] = "Found the character '%c'. stdin will be directed from a file.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for input redirection character */ + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, msg, INPUT_REDIRECTION_CHAR);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            if (*(arg + 1)) {
-                // Input file was specified
-#ifdef DEBUG
-                if (debug) {
-                    // Create debug message
-                    const char msg[] = "Found an argument after the character '%c'. stdin will be directed from this file '%s'.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for input redirection character */ + strlen(*(arg + 1)) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, INPUT_REDIRECTION_CHAR, *(arg + 1));
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                // Check if the file exists
-                if (!access(*(arg + 1), R_OK)) {
-                    if (!(input_redir = fopen(*(arg + 1), "r"))) sys_err("fopen"); // attempt to open the file for reading
-                } else {
-                    // Create error message
-                    const char msg[] = "Unable to open the file '%s' for reading. stdin will not be redirected.";
-                    char * err_msg;
-
-                    // Memory allocation
-                    if (!(err_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(*(arg + 1)) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output error message
-                    sprintf(err_msg, msg, *(arg + 1));
-                    err(err_msg);
-
-                    // Clean up
-                    free(err_msg);
-                }
-
-                // Remove arguments
-#ifdef DEBUG
-                if(debug) {
-                    // Create debug message
-                    const char msg[] = "Removing '%c %s' from argument list.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for input redirection character */ + strlen(*(arg + 1)) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, INPUT_REDIRECTION_CHAR, *(arg + 1));
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                *(array_movetoend(arg + 1)) = 0; // move input redirection file to end of argument array and set to null
-                *(array_movetoend(arg)) = 0; // move input redirection character to end of argument array and set to null
-            } else {
-                // Input file not specified
-                const char input_redirection_string[2]= {INPUT_REDIRECTION_CHAR, '\0'};
-                error_no_argument(input_redirection_string);
-            }
-            break;
-        }
-        arg++;
-    }
-}
-
-/*
- * This function loops through the argument array and looks for the input
- * redirection character (defined in strings.h) and input redirection file. Upon
- * finding these arguments, the function will set a flag and set these argument
- * to NULL.
- *
- * Note that the don't wait character should be the last argument of the
- * argument array. No check is made for this, but all arguments after the don't
- * wait character will be ignored.
- *
- * PARAMETERS
- *     args: A pointer to an array of character strings. MUST be terminated by a
- *         zero element.
- */
-void check_for_output_redirection(char ** args) {
-    char ** arg = args; // working pointer through arguments
-
-#ifdef DEBUG
-    if (debug) {
-        // Create debug message
-        const char msg[] = "Checking for output redirection character '%c'.";
-        char * dbg_msg;
-
-        // Memory allocation
-        if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for output redirection character */ + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-        // Output debug message
-        sprintf(dbg_msg, msg, OUTPUT_REDIRECTION_CHAR);
-        debug_message(dbg_msg);
-
-        // Clean up
-        free(dbg_msg);
-    }
-
-#endif // #ifdef DEBUG
-    // Look for output redirection character
-    while (*arg) {
-        if ((strlen(*arg) == 1) && ((*arg)[0] == OUTPUT_REDIRECTION_CHAR)) {
-            // Output redirection (truncate) has been specified
-#ifdef DEBUG
-            if (debug) {
-                // Create debug message
-                const char msg[] = "Found the character '%c'. stdout will be directed to a file.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for output redirection character */ + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, msg, OUTPUT_REDIRECTION_CHAR);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            if (*(arg + 1)) {
-                // Output file was specified
-#ifdef DEBUG
-                if (debug) {
-                        // Create debug message
-                        const char msg[] = "Found an argument after the character '%c'. stdout will be directed to this file '%s'.";
-                        char * dbg_msg;
-
-                        // Memory allocation
-                        if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for output redirection character */ + strlen(*(arg + 1)) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                        // Output debug message
-                        sprintf(dbg_msg, msg, OUTPUT_REDIRECTION_CHAR, *(arg + 1));
-                        debug_message(dbg_msg);
-
-                        // Clean up
-                        free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                if (!(output_redir = fopen(*(arg + 1), "w"))) sys_err("fopen"); // attempt to open the file for writing
-
-                // Remove arguments
-#ifdef DEBUG
-                if (debug) {
-                    // Create debug message
-                    const char msg[] = "Removing '%c %s' from argument list.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 1 /* for output redirection character */ + strlen(*(arg + 1)) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, OUTPUT_REDIRECTION_CHAR, *(arg + 1));
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                *(array_movetoend(arg + 1)) = 0; // move output redirection file to end of argument array and set to null
-                *(array_movetoend(arg)) = 0; // move output redirection character to end of argument array and set to null
-            } else {
-                // Output file not specified
-                const char output_redirection_string[2] = {OUTPUT_REDIRECTION_CHAR, '\0'};
-                error_no_argument(output_redirection_string);
-            }
-            break;
-        } else if ((strlen(*arg) == 2) && ((*arg)[0] == OUTPUT_REDIRECTION_CHAR) && ((*arg)[1] == OUTPUT_REDIRECTION_CHAR)) {
-            // Output redirection (append) has been specified
-#ifdef DEBUG
-            if (debug) {
-                // Create debug message
-                const char msg[] = "Found the characters '%c%c'. stdout will be appended to a file.";
-                char * dbg_msg;
-
-                // Memory allocation
-                if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 2 /* for output redirection characters */ + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                // Output debug message
-                sprintf(dbg_msg, msg, OUTPUT_REDIRECTION_CHAR, OUTPUT_REDIRECTION_CHAR);
-                debug_message(dbg_msg);
-
-                // Clean up
-                free(dbg_msg);
-            }
-
-#endif // #ifdef DEBUG
-            if (*(arg + 1)) {
-                // Output file was specified
-#ifdef DEBUG
-                if (debug) {
-                    // Create debug message
-                    const char msg[] = "Found an argument after the characters '%c%c'. stdout will be appended to this file '%s'.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 2 /* for output redirection characters */ + strlen(*(arg + 1)) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, INPUT_REDIRECTION_CHAR, INPUT_REDIRECTION_CHAR, *(arg + 1));
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                if (!(output_redir = fopen(*(arg + 1), "a"))) sys_err("fopen"); /* attempt to open the file for writing */
-
-                // Remove arguments
-#ifdef DEBUG
-                if(debug) {
-                    // Create debug message
-                    const char msg[] = "Removing '%c%c %s' from argument list.";
-                    char * dbg_msg;
-
-                    // Memory allocation
-                    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + 2 /* for output redirection characters */ + strlen(*(arg + 1)) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-                    // Output debug message
-                    sprintf(dbg_msg, msg, OUTPUT_REDIRECTION_CHAR, OUTPUT_REDIRECTION_CHAR, *(arg + 1));
-                    debug_message(dbg_msg);
-
-                    // Clean up
-                    free(dbg_msg);
-                }
-
-#endif // #ifdef DEBUG
-                *(array_movetoend(arg + 1)) = 0; // move output redirection file to end of argument array and set to null
-                *(array_movetoend(arg)) = 0; // move output redirection character to end of argument array and set to null
-            } else {
-                // Output file not specified
-                const char output_redirection_string[2] = {OUTPUT_REDIRECTION_CHAR, '\0'};
-                error_no_argument(output_redirection_string);
-            }
-            break;
-        }
-        arg++;
-    }
-}
-
-/*
- * Display an error message that a command requiring an argument has been
- * executed without an argument.
- *
- * PARAMETERS
- *     command: A null-terminated string containing the command for which
- *         arguments were required but not specified.
- */
-void error_no_argument(const char * command) {
-    // Create error message
-    const char msg[] = "No argument found for command '%s'.";
-    char * err_msg;
-
-    // Memory allocation
-    if (!(err_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(command) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); /* attempt to allocate memory for err_msg */
-
-    // Output error message
-    sprintf(err_msg, msg, command);
-    err(err_msg);
-
-    // Clean up
-    free(err_msg);
-}
-
-/*
- * Display an error message that a command has been specified with an unknown
- * argument.
- *
- * PARAMETERS
- *     command: A null-terminated string containing the command for which an
- *         argument was unrecognised.
- *     arg: A null-terminated string containing the unrecognised argument.
- */
-void error_unrecognised_argument(const char * command, const char * arg) {
-    // Create error message
-    const char msg[] = "Unrecognised argument to command '%s': '%s'.";
-    char * err_msg;
-
-    // Memory allocation
-    if (!(err_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(command) + strlen(arg) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); /* attempt to allocate memory for err_msg */
-
-    // Output error message
-    sprintf(err_msg, msg, command, arg);
-    err(err_msg);
-
-    // Clean up
-    free(err_msg);
-}
-
-/*
- * Reset the process information.
- */
-void reset_process_information(void) {
-    // Reset process information
-    proc_info.pid = 0;
-    proc_info.dont_wait = FALSE; // by default, run commands in the foreground
-    proc_info.status = 0;
-}
-
-#ifdef DEBUG
-/*
- * Turns debug mode on or off.
- *
- * PARAMETERS
- *     state: The boolean state to set debug mode to.
- *
- * RETURN VALUE
- * An exit status indicating to the shell what action should be taken.
- */
-int debug_mode(const boolean state) {
-    if (proc_info.dont_wait) {
-        err("Background execution is not supported for this command. Ignoring this parameter.");
-    }
-    if (input_redir) {
-        err("Input redirection is not supported for this command. Ignoring this parameter.");
-    }
-    if (output_redir) {
-        err("Output redirection is not supported for this command. Ignoring this parameter.");
-    }
-
-    if (state) {
-        debug = TRUE;
-        debug_message("Debug mode on.");
-    }
-    else {
-        debug = FALSE;
-        debug_message("Debug mode off.");
-    }
-
-    // Return an exit status indicating to the shell that it should continue executing
-    return EXIT_STATUS_CONTINUE;
-}
-
-/*
- * Display a debug message indicating that a command has been recognised.
- *
- * PARAMETERS
- *     command: The command that was recognised.
- *     command_name: The full name of the command that was recognised.
- */
-void debug_command_recognised_message(const char * command, const char * command_name) {
-    // Create debug message
-    const char msg[] = "%s command '%s' recognised.";
-    char * dbg_msg;
-
-    // Memory allocation
-    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(command) + strlen(command_name) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-    // Output debug message
-    sprintf(dbg_msg, msg, command_name, command);
-    debug_message(dbg_msg);
-
-    // Clean up
-    free(dbg_msg);
-}
-
-/*
- * Display a debug message indicating that a command has been executed.
- *
- * PARAMETERS
- *     command:         The command that was executed.
- *     command_name:    The full name of the command that was executed.
- */
-void debug_command_executed_message(const char * command, const char * command_name) {
-    // Create debug message
-    const char msg[] = "%s command '%s' executed.";
-    char * dbg_msg;
-
-    // Memory allocation
-    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + strlen(command) + strlen(command_name) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-    // Output debug message
-    sprintf(dbg_msg, msg, command_name, command);
-    debug_message(dbg_msg);
-
-    // Clean up
-    free(dbg_msg);
-}
-
-/*
- * Display a debug message showing the input that has been read.
- *
- * PARAMETERS
- *     buffer: A null-terminated string containing the text that has been read.
- */
-void debug_read_line_message(const char * buffer) {
-    // Create debug message
-    const char msg[] = "Read line: '%.*s'.";
-    char * dbg_msg;
-
-    // Memory allocation
-    if (!(dbg_msg = (char *) malloc((size_t) ((strlen(msg) + (strlen(buffer) - 1 /* for new line character which will not be output */) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-    // Output debug message
-    sprintf(dbg_msg, msg, (int)(strlen(buffer) - 1 /* don't print new-line character */), buffer);
-    debug_message(dbg_msg);
-
-    // Clean up
-    free(dbg_msg);
-}
-
-/*
- * Display a debug message showing the command and arguments that have been
- * recognised and will be processed.
- *
- * PARAMETERS
- *     command: The command that will be processed.
- *     args: A pointer to the first argument that will be processed.
- */
-void debug_command_args_message(const char * command, const char ** args) {
-    const char ** arg = args; // working pointer through arguments
-    size_t size = 0; // current size of dbg_msg
-
-    // Create debug message
-    const char msg[] = "Command '%s' was input.\n";
-    const char args_msg[] = "%sArgument %d: '%s'\n";
-    char * dbg_msg;
-
-    // Memory allocation
-    if (!(dbg_msg = (char *) malloc((size_t) (size += ((strlen(msg) + strlen(command) + 1 /* for null character */) * sizeof(char)))))) sys_err("malloc"); // attempt to allocate memory for dbg_msg
-
-    // Output debug message
-    sprintf(dbg_msg, msg, command);
-    unsigned int i = 1;
-    arg = args;
-    while (*(++arg)) {
-        if (!(dbg_msg = (char *) realloc(dbg_msg, (size_t) (size += ((strlen(args_msg) + digits(i) + strlen(*arg)) * sizeof(char)))))) sys_err("realloc"); // attempt to reallocate memory for dbg_msg
-        sprintf(dbg_msg, args_msg, dbg_msg, i++, *arg);
-    }
-    debug_message(dbg_msg);
-
-    // Clean up
-    free(dbg_msg);
-}
-#endif // #ifdef DEBUG
+/*
+ * myshell.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ */
+
+#include "../inc/myshell.h"
+
+process_information proc_info; // information about child processes
+char * path; // path to the executable
+char * home; // the directory from which the shell was started
+arena line_arena; // memory for the current command line
+
+#define BUILTIN_ENTRY(command, name, function, capabilities) {command, name, function, capabilities},
+const builtin builtins[] = {
+    BUILTINS(BUILTIN_ENTRY)
+}; // the internal commands
+#undef BUILTIN_ENTRY
+
+int builtin_first[256]; // index of the first internal command starting with each character (-1 if none)
+int builtin_next[NUM_BUILTINS]; // index of the next internal command starting with the same character (-1 if none)
+boolean interactive; // is the shell reading commands from a terminal?
+boolean job_control; // are jobs run in their own process groups?
+const char * command_line; // the command line being executed (NOT null-terminated)
+size_t command_line_length; // length of the command line being executed
+int last_status = 0; // exit status of the last command executed
+boolean last_line = FALSE; // is the command line being executed the last of the input?
+boolean replace_last = TRUE; // may the shell be replaced by the last command it executes? (not in a session of a shell server)
+reader batch_reader; // reads command lines ahead when the shell is not reading from a terminal
+#ifdef DEBUG
+
+boolean debug; // is debug mode on?
+#endif // #ifdef DEBUG
+
+/*
+ * Runs the 'myshell' shell. With CLIENT_OPTION, the command lines are executed
+ * by a shell server (see client_run) if one is listening on the socket, and
+ * otherwise by this process as usual. With SERVE_OPTION, the shell becomes a
+ * server which executes the command lines of its clients (see server_run).
+ * With ZYGOTE_OPTION, external programs are launched from a fork server which
+ * is started before anything else (see zygote_start).
+ *
+ * PARAMETERS
+ *     argc: Number of arguments.
+ *     argv: Pointer to argument array.
+ *
+ * RETURN VALUE
+ * The exit status of the shell (see run_shell).
+ */
+int main(int argc, char ** argv) {
+    int exit_status; // exit status of the shell
+
+    arena_init(&line_arena);
+
+    signal(SIGINT, SIG_IGN); // disable SIGINT to prevent shell from terminating with Ctrl+C
+
+    // Pass the command lines to a shell server if possible
+    if ((argc > 1) && !strcmp(argv[1], CLIENT_OPTION)) {
+        if (argc < 3) {
+            error_no_argument(CLIENT_OPTION);
+            return EXIT_FAILURE;
+        }
+        if ((exit_status = client_run(argv[2], argv + 3)) >= 0) {
+            return exit_status;
+        }
+
+        // Execute the command lines here instead, with the options which follow the socket
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+
+    // Start the fork server before the shell has grown
+    if ((argc > 1) && !strcmp(argv[1], ZYGOTE_OPTION)) {
+        zygote_start();
+
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
+
+    // Get home directory
+    home = getcwd(NULL, (size_t) 0); // getcwd will dynamically allocate memory for home
+
+    // Import the environment variables
+    variables_setup();
+
+    // Get path to executable and add it to the environment variables
+    path = get_path(NULL); // get path to the executable
+    variable_set("shell", strlen("shell"), path, TRUE); // set the 'shell' environment variable to the path to the shell, overwriting any existing value
+
+    lexer_setup();
+    builtin_setup();
+
+    if ((argc > 1) && !strcmp(argv[1], SERVE_OPTION)) {
+        if (argc < 3) {
+            error_no_argument(SERVE_OPTION);
+            exit_status = EXIT_FAILURE;
+        } else {
+            exit_status = server_run(argv[2]);
+        }
+    } else {
+        exit_status = run_shell(argc, argv);
+    }
+
+    // Clean up
+    zygote_stop();
+    free(home); // free the memory dynamically allocated by getcwd
+    child_environment_reset(); // the environment for child processes refers to path
+    free(path); // free the memory dynamically allocated by get_path
+    variables_free();
+    arena_free(&line_arena);
+
+    return exit_status;
+}
+
+/*
+ * Execute the command lines of the shell, as specified by the command line
+ * options and arguments of the shell: interactively, from a batch file (or
+ * stdin), or from a command line given as an argument. The shell must already
+ * have been set up (see main).
+ *
+ * PARAMETERS
+ *     argc: Number of arguments.
+ *     argv: Pointer to argument array.
+ *
+ * RETURN VALUE
+ * The exit status of the last command executed, or (for a parallel batch)
+ * EXIT_SUCCESS if every command line succeeded and otherwise EXIT_FAILURE.
+ */
+int run_shell(int argc, char ** argv) {
+    FILE * input; // the source of the command inputs (null if a command line was given as an argument)
+    const char * command_string = NULL; // command line given as an argument
+    input_source source; // splits the input into lines
+    boolean display_prompt; // should the prompt be displayed?
+    char ** option; // working pointer through command line options
+    unsigned int num_workers = 1; // number of command lines to execute at the same time
+    boolean keep_going = FALSE; // should command lines continue to be executed after a failure?
+    int exit_status = EXIT_SUCCESS; // exit status of the shell
+
+    char ** args; // pointers to argument strings
+
+    int return_val = EXIT_STATUS_CONTINUE; // return value of last internal command call
+
+    char * cwd; // current working directory
+
+    // Check for command line options
+    for (option = argv + 1; *option && (**option == '-') && (*option)[1]; option++) {
+        if (!strncmp(*option, PARALLEL_OPTION, strlen(PARALLEL_OPTION))) {
+            // Number of workers is either attached to the option or the next argument
+            const char * workers = (*option)[strlen(PARALLEL_OPTION)] ? *option + strlen(PARALLEL_OPTION) : *++option;
+            char * end; // end of the number of workers
+
+            if (!workers || !(num_workers = (unsigned int) strtoul(workers, &end, 10)) || *end) {
+                error_unrecognised_argument(PARALLEL_OPTION, workers ? workers : "");
+                return EXIT_FAILURE;
+            }
+        } else if (!strcmp(*option, KEEP_GOING_OPTION)) {
+            keep_going = TRUE;
+        } else if (!strcmp(*option, COMMAND_OPTION)) {
+            // The command line is the next argument
+            if (!(command_string = *++option)) {
+                error_no_argument(COMMAND_OPTION);
+                return EXIT_FAILURE;
+            }
+            option++;
+            break;
+        } else {
+            error_unrecognised_argument(*argv, *option);
+            return EXIT_FAILURE;
+        }
+    }
+    argc -= (int) (option - argv) - 1;
+    argv = option - 1;
+
+    // Check for batch file input
+    if (command_string) {
+        // Command line was given as an argument
+        if (argc > 1) {
+            // Too many arguments were entered
+            err("Too many arguments were specified. Some arguments will be ignored.");
+        }
+
+        input = NULL;
+        display_prompt = FALSE;
+    } else if (argc > 1) {
+        if (argc > 2) {
+        // Too many arguments were entered
+            err("Too many arguments were specified. Some arguments will be ignored.");
+        }
+
+        if (!strcmp(argv[1], STDIN_BATCH_FILE)) {
+            // Batch file is stdin
+            input = stdin;
+            display_prompt = FALSE; // don't display a prompt when reading input from a batch file
+        } else if (argv[1]) {
+            // Batch file was specified
+#ifdef DEBUG
+            if (debug) {
+                const char msg[] = "Input batch file '%s' was specified. Input commands will be parsed from this file.";
+                char * dbg_msg;
+
+                // Memory allocation
+                dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(argv[1]) + 1 /* null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+                // Output debug message
+                sprintf(dbg_msg, msg, argv[1]);
+                debug_message(dbg_msg);
+            }
+
+#endif // #ifdef DEBUG
+            if (!(input = fopen(argv[1], "re"))) sys_err("fopen"); // attempt to open the input batch file
+            display_prompt = FALSE; // don't display a prompt when reading input from a file
+        } else {
+#ifdef DEBUG
+            if (debug) {
+                debug_message("No input batch file was specified. Input commands will be parsed from stdin.");
+            }
+
+#endif // #ifdef DEBUG
+            input = stdin;
+            display_prompt = TRUE;
+        }
+    } else {
+        input = stdin;
+        display_prompt = TRUE;
+    }
+
+    interactive = display_prompt && isatty(fileno(input));
+    if (input) {
+        input_open(&source, fileno(input));
+    } else {
+        input_open_string(&source, command_string, strlen(command_string));
+    }
+    job_control = interactive && (tcgetsid(fileno(input)) == getsid(0)); // only if the terminal belongs to the session of the shell (see server_session)
+    jobs_setup(); // child processes are reaped by the SIGCHLD handler
+
+    // Read command lines ahead of their execution unless they are being entered at a terminal
+    if (!interactive) {
+        reader_start(&batch_reader, &source);
+    }
+
+    if ((num_workers > 1) && !interactive) {
+        // Execute the command lines in parallel
+        exit_status = process_parallel_batch(&source, num_workers, keep_going);
+    } else {
+        // Keep reading input until "quit" command or EOF of stdin/redirected input
+        while (TRUE) {
+#ifdef DEBUG
+            if (debug) {
+                debug_arena_message(&line_arena);
+            }
+
+#endif // #ifdef DEBUG
+            reset_process_information();
+            arena_reset(&line_arena);
+
+            // Report jobs which have finished or stopped
+            jobs_notify();
+
+            // Output shell prompt if required
+            if (display_prompt) {
+                // Getting current working directory
+                cwd = (char *) arena_alloc(&line_arena, (size_t) (PATH_MAX * sizeof(char))); // allocate memory for cwd from the line arena
+                if (!getcwd(cwd, (size_t) PATH_MAX)) sys_err("getcwd"); // attempt to get the current working directory
+
+                output_shell_prompt(cwd);
+                writer_flush(&shell_output); // the prompt (and any output before it) must appear before the shell waits for input
+            }
+
+            // Get input from stdin/batch file
+            if (!(args = read_line(&source))) {
+                break; // end of input
+            }
+
+            return_val = execute_line(args);
+
+            // Check if the shell should quit
+            if (return_val == EXIT_STATUS_QUIT) {
+                break;
+            }
+        }
+
+        exit_status = last_status;
+    }
+
+    // Clean up
+    writer_flush(&shell_output);
+    reader_stop(&batch_reader);
+    input_close(&source);
+    if (input && fclose(input)) sys_err("fclose"); // attempt to close the input batch file
+    input = NULL;
+
+    return exit_status;
+}
+
+/*
+ * Get the next command line and split it into arguments. The command line is
+ * taken from the batch reader if it is running, and otherwise read from the
+ * input (together with its here-documents). The command line being executed (command_line) is updated, and
+ * last_line is set if no command line follows it.
+ *
+ * PARAMETERS
+ *     input: The input from which the command line should be read.
+ *
+ * RETURN VALUE
+ * A pointer to an array of character strings, terminated by a null entry, or
+ * null at the end of the input.
+ */
+char ** read_line(input_source * input) {
+    reader_command * command; // command line from the batch reader
+    const char * input_buffer; // line buffer
+    size_t length; // length of the line
+    char ** args; // pointers to argument strings
+#ifdef DEBUG
+    unsigned int num_args = 0; // number of arguments
+#endif // #ifdef DEBUG
+
+    if (batch_reader.running) {
+        if (!(command = reader_next(&batch_reader))) {
+            return NULL;
+        }
+        input_buffer = command->line;
+        length = command->length;
+        args = command->args;
+        last_line = command->last;
+    } else {
+        if (!(input_buffer = get_input(input, &line_arena, &length))) {
+            return NULL;
+        }
+        args = tokenize_line(&line_arena, input_buffer, length);
+        read_here_documents(input, &line_arena, args);
+        last_line = input_at_end(input);
+    }
+    command_line = input_buffer;
+    command_line_length = length;
+
+#ifdef DEBUG
+    if (debug) {
+        const char msg[] = "Tokenized input into %d arguments.";
+        char * dbg_msg;
+
+        debug_read_line_message(input_buffer, length);
+
+        // Count the number of arguments
+        while (args[num_args]) {
+            num_args++;
+        }
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + digits(num_args) + 1 /* null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, num_args);
+        debug_message(dbg_msg);
+    }
+
+#endif // #ifdef DEBUG
+    return args;
+}
+
+/*
+ * Execute the arguments of a command line. The command line is a list of
+ * commands (or pipelines) separated by SEQUENCE_OPERATOR, AND_OPERATOR or
+ * OR_OPERATOR. A command following AND_OPERATOR is only executed if the last
+ * command executed succeeded, and a command following OR_OPERATOR is only
+ * executed if the last command executed failed. The exit status of each
+ * command executed is stored in last_status.
+ *
+ * The variables in the arguments of each command are expanded just before the
+ * command is executed, so that they see the variables set (and the exit status
+ * of) the commands before them, and then pathname patterns are expanded. A
+ * command which only assigns variables sets them in the shell.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int execute_line(char ** args) {
+    char ** command = args; // the first argument of the current command
+    char ** arg; // working pointer through arguments
+    const char * separator; // the operator after the current command (null at the end of the line)
+    boolean skip = FALSE; // should the current command be skipped?
+    int return_val = EXIT_STATUS_CONTINUE; // return value of the commands
+
+    while (TRUE) {
+        // Find the end of this command
+        for (arg = command; *arg && !is_list_operator(*arg); arg++);
+        separator = *arg;
+        *arg = NULL;
+
+        if (!skip && *command) {
+            reset_process_information();
+            proc_info.last = last_line && !separator;
+            if (is_assignment_command(command)) {
+                process_assignments(command);
+            } else {
+                return_val = execute_list_command(expand_pathnames(&line_arena, expand_arguments(&line_arena, command)));
+            }
+            last_status = job_exit_status(proc_info.status);
+
+            // Check if the shell should quit
+            if (return_val == EXIT_STATUS_QUIT) {
+                break;
+            }
+        }
+
+        if (!separator) {
+            break;
+        }
+
+        // Decide whether the next command should be executed
+        if (!strcmp(separator, AND_OPERATOR)) {
+            skip = (last_status != 0);
+        } else if (!strcmp(separator, OR_OPERATOR)) {
+            skip = (last_status == 0);
+        } else {
+            skip = FALSE;
+        }
+        command = arg + 1;
+    }
+
+    return return_val;
+}
+
+/*
+ * Check whether every argument of a command is a variable assignment (see
+ * is_assignment).
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * TRUE if the command only assigns variables, otherwise FALSE.
+ */
+boolean is_assignment_command(char ** args) {
+    if (!*args) {
+        return FALSE;
+    }
+
+    for (; *args; args++) {
+        if (!is_assignment(*args)) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Set the variables assigned by a command. The variables in each value are
+ * expanded first. A variable which is already exported remains exported.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of variable assignments. MUST be terminated
+ *         by a null entry.
+ */
+void process_assignments(char ** args) {
+    char * assignment; // the expanded assignment
+    size_t length; // length of the variable name
+
+    for (; *args; args++) {
+        assignment = ((*args)[-1] & TOKEN_EXPAND) ? expand_token(&line_arena, *args, NULL) : *args;
+        if (assignment[-1] & TOKEN_GLOB) {
+            remove_escapes(assignment); // a value is never a pathname pattern
+        }
+        length = variable_name_length(assignment);
+        variable_set(assignment, length, assignment + length + 1 /* for ASSIGNMENT_CHARACTER */, FALSE);
+#ifdef DEBUG
+
+        if (debug) {
+            // Create debug message
+            const char msg[] = "Set variable '%s'.";
+            char * dbg_msg;
+
+            // Memory allocation
+            dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(assignment) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+            // Output debug message
+            sprintf(dbg_msg, msg, assignment);
+            debug_message(dbg_msg);
+        }
+#endif // #ifdef DEBUG
+    }
+}
+
+/*
+ * Execute a single command (or pipeline) of a command line, handling
+ * background execution and redirection.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int execute_list_command(char ** args) {
+    int return_val = EXIT_STATUS_CONTINUE; // return value of the commands
+
+    check_for_dont_wait(args);
+    proc_info.command = command_text(args);
+
+    // If anything was input, execute the commands
+    if (*args) {
+#ifdef DEBUG
+        if (debug) {
+            debug_command_args_message(*args, (const char **) args);
+        }
+
+#endif // #ifdef DEBUG
+        if (count_pipes(args)) {
+            return_val = process_pipeline(args);
+        } else if (redirect_parse(&redirects, args) && *args) {
+            return_val = execute_command(args);
+        }
+    }
+
+    // Close the files opened for redirection
+    redirect_close(&redirects);
+
+    return return_val;
+}
+
+/*
+ * Build the text of a command (or pipeline) from its arguments, as it is shown
+ * by the job table. The arguments are separated by spaces, and a command which
+ * is executed in the background is followed by the don't wait character.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * A pointer to the null-terminated text of the command, allocated from the
+ * line arena.
+ */
+char * command_text(char ** args) {
+    size_t length = 0; // length of the text
+    char * text; // the text of the command
+    char * p; // next free character of text
+
+    for (char ** arg = args; *arg; arg++) {
+        length += strlen(*arg) + 1 /* for space */;
+    }
+
+    // Memory allocation
+    text = (char *) arena_alloc(&line_arena, (size_t) ((length + 2 /* for don't wait character */ + 1 /* for null character */) * sizeof(char))); // allocate memory for text from the line arena
+
+    p = text;
+    for (char ** arg = args; *arg; arg++) {
+        if (p != text) {
+            *p++ = ' ';
+        }
+        length = strlen(*arg);
+        memcpy(p, *arg, length);
+        p += length;
+    }
+    if (proc_info.dont_wait) {
+        *p++ = ' ';
+        *p++ = DONT_WAIT_CHARACTER;
+    }
+    *p = '\0';
+
+    return text;
+}
+
+/*
+ * Execute the command lines of a batch file in parallel. Up to num_workers
+ * command lines are executed at the same time, each in a child process of its
+ * own. The output of each command line is captured in a temporary file and
+ * copied to the output of the shell in the order in which the command lines
+ * appear, so that the output is the same as if the command lines had been
+ * executed one at a time.
+ *
+ * A command line which uses an internal command that changes the state of the
+ * shell (BUILTIN_SHELL) is a barrier: every earlier command line is allowed to
+ * finish, and then the command line is executed by the shell itself.
+ *
+ * PARAMETERS
+ *     input: The batch file.
+ *     num_workers: The maximum number of command lines to execute at the same
+ *         time.
+ *     keep_going: Should further command lines be executed after a command
+ *         line has failed?
+ *
+ * RETURN VALUE
+ * EXIT_SUCCESS if every command line succeeded, otherwise EXIT_FAILURE.
+ */
+int process_parallel_batch(input_source * input, const unsigned int num_workers, const boolean keep_going) {
+    const unsigned int num_slots = num_workers * PARALLEL_WINDOW; // number of command lines which may be waiting to be output
+    parallel_slot * slots; // the command lines which have been launched, oldest first from head
+    unsigned int head = 0; // index of the oldest command line in slots
+    unsigned int num_used = 0; // number of command lines in slots
+    unsigned int num_running; // number of command lines in slots which are still running
+    boolean stop = FALSE; // should no further command lines be launched?
+    boolean failed = FALSE; // has any command line failed?
+    char ** args; // pointers to argument strings
+    parallel_slot * slot; // a slot
+
+    // Memory allocation
+    if (!(slots = (parallel_slot *) malloc((size_t) (num_slots * sizeof(parallel_slot))))) sys_err("malloc"); // attempt to allocate memory for slots
+    for (unsigned int i = 0; i < num_slots; ++i) {
+        slots[i].j = NULL;
+        slots[i].output_fds[0] = -1;
+        slots[i].output_fds[1] = -1;
+    }
+
+    while (TRUE) {
+        // Output the command lines which have finished, in order
+        jobs_update();
+        while (num_used && ((slots[head].j->state == JOB_DONE) || stop)) {
+            if (finish_parallel_slot(&slots[head])) {
+                failed = TRUE;
+                stop |= !keep_going;
+            }
+            head = (head + 1) % num_slots;
+            num_used--;
+        }
+
+        // Count the command lines which are still running, and stop launching command lines as soon as one fails
+        num_running = 0;
+        for (unsigned int i = 0; i < num_used; ++i) {
+            slot = &slots[(head + i) % num_slots];
+            if (slot->j->state != JOB_DONE) {
+                num_running++;
+            } else if (!keep_going && job_exit_status(slot->j->status)) {
+                stop = TRUE;
+            }
+        }
+
+        if (stop || (num_running >= num_workers) || (num_used == num_slots)) {
+            if (!num_used) {
+                break;
+            }
+
+            // Wait for a command line to finish
+            jobs_wait_change();
+            continue;
+        }
+
+        // Read the next command line
+#ifdef DEBUG
+        if (debug) {
+            debug_arena_message(&line_arena);
+        }
+
+#endif // #ifdef DEBUG
+        reset_process_information();
+        arena_reset(&line_arena);
+
+        if (!(args = read_line(input))) {
+            stop = TRUE; // end of input
+            continue;
+        }
+        if (!*args) {
+            continue;
+        }
+
+        if (is_barrier_line(args)) {
+            // Wait for every earlier command line to finish
+            for (; num_used; head = (head + 1) % num_slots, num_used--) {
+                if (finish_parallel_slot(&slots[head])) {
+                    failed = TRUE;
+                    stop |= !keep_going;
+                }
+            }
+
+            if (stop) {
+                break;
+            }
+
+            // Execute the command line in the shell
+            if (execute_line(args) == EXIT_STATUS_QUIT) {
+                stop = TRUE;
+            }
+            if (last_status) {
+                failed = TRUE;
+                stop |= !keep_going;
+            }
+            continue;
+        }
+
+        slot = &slots[(head + num_used) % num_slots];
+        if (launch_parallel_line(slot, args)) {
+            num_used++;
+        } else {
+            failed = TRUE;
+            stop |= !keep_going;
+        }
+    }
+
+    // Clean up
+    for (unsigned int i = 0; i < num_slots; ++i) {
+        for (unsigned int k = 0; k < 2; ++k) {
+            if (slots[i].output_fds[k] >= 0) {
+                close(slots[i].output_fds[k]);
+            }
+        }
+    }
+    free(slots);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+ * Check whether a command line uses an internal command which changes the state
+ * of the shell (or assigns a variable), and so must be executed by the shell
+ * itself.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * TRUE if any command of the command line is such an internal command,
+ * otherwise FALSE.
+ */
+boolean is_barrier_line(char ** args) {
+    const builtin * command; // the internal command
+    boolean first = TRUE; // is the current argument the first of a command?
+
+    for (; *args; args++) {
+        if (first && (((command = find_builtin(*args)) && (command->capabilities & BUILTIN_SHELL)) || is_assignment(*args))) {
+            return TRUE;
+        }
+        first = is_pipe(*args) || is_list_operator(*args);
+    }
+
+    return FALSE;
+}
+
+/*
+ * Launch a command line of a parallel batch in a child process, with its
+ * standard output and standard error captured in the temporary files of a
+ * slot.
+ *
+ * PARAMETERS
+ *     slot: The slot for the command line.
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * TRUE if the command line was launched, otherwise FALSE.
+ */
+boolean launch_parallel_line(parallel_slot * slot, char ** args) {
+    pid_t pid; // process ID of the child process
+    FILE * file; // a new temporary file
+
+    // Create or empty the temporary files
+    for (unsigned int k = 0; k < 2; ++k) {
+        if (slot->output_fds[k] < 0) {
+            if (!(file = tmpfile()) || ((slot->output_fds[k] = dup(fileno(file))) < 0)) sys_err("tmpfile"); // attempt to create a temporary file
+            fclose(file);
+            fcntl(slot->output_fds[k], F_SETFD, FD_CLOEXEC);
+        } else if (ftruncate(slot->output_fds[k], (off_t) 0)) {
+            sys_err("ftruncate");
+        }
+        lseek(slot->output_fds[k], (off_t) 0, SEEK_SET);
+    }
+
+    // Make sure that buffered output is not duplicated in the child process
+    writer_flush(&shell_output);
+    fflush(stderr);
+
+    // Fork the current process
+    switch (pid = fork()) {
+        case -1: // fork failed
+            error_launch(*args);
+            return FALSE;
+
+        case 0: // child
+            dup2(slot->output_fds[0], STDOUT_FILENO);
+            dup2(slot->output_fds[1], STDERR_FILENO);
+
+            // The jobs of the shell are not children of this process
+            jobs_clear();
+            last_line = TRUE; // the process exits after this command line
+
+            execute_line(args);
+            jobs_wait_all();
+            writer_flush(&shell_output);
+            fflush(stderr);
+            _exit(last_status);
+    }
+
+#ifdef DEBUG
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Launched command '%s' in parallel [PID: %d].";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(*args) + digits(pid) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, *args, pid);
+        debug_message(dbg_msg);
+    }
+
+#endif // #ifdef DEBUG
+    slot->j = job_create(command_line, command_line_length);
+    job_add_process(slot->j, pid);
+    return TRUE;
+}
+
+/*
+ * Wait for the command line of a parallel batch slot to finish, and copy its
+ * captured output to the output of the shell.
+ *
+ * PARAMETERS
+ *     slot: The slot.
+ *
+ * RETURN VALUE
+ * The exit status of the command line.
+ */
+int finish_parallel_slot(parallel_slot * slot) {
+    const int status = job_exit_status(job_wait(slot->j, FALSE)); // exit status of the command line
+
+    slot->j = NULL;
+    writer_flush(&shell_output);
+    copy_captured_output(slot->output_fds[0], stdout);
+    copy_captured_output(slot->output_fds[1], stderr);
+
+    return status;
+}
+
+/*
+ * Copy the contents of a temporary file to an output stream.
+ *
+ * PARAMETERS
+ *     fd: The temporary file.
+ *     stream: The output stream.
+ */
+void copy_captured_output(const int fd, FILE * stream) {
+    char buffer[BUFSIZ]; // data read from the temporary file
+    ssize_t length; // number of bytes read
+    ssize_t written; // number of bytes written
+
+    fflush(stream);
+    lseek(fd, (off_t) 0, SEEK_SET);
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t offset = 0; offset < length; offset += written) {
+            if ((written = write(fileno(stream), buffer + offset, (size_t) (length - offset))) < 0) {
+                return;
+            }
+        }
+    }
+}
+
+/*
+ * Execute a single command, which may be an internal command or an external
+ * command. If an internal command does not support redirection, a warning is
+ * displayed and the request is ignored.
+ *
+ * An internal command which is executed in the background runs in a child
+ * process (see launch_internal_command), as a job of the shell like any other.
+ * Only internal commands which do not change the state of the shell
+ * (BUILTIN_BACKGROUND) may be executed in the background, since a change made
+ * by a child process would be lost. Any other internal command is not executed
+ * and an error message is displayed.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int execute_command(char ** args) {
+    const builtin * command = find_builtin(*args); // the internal command
+    int return_val; // return value of the command
+    int saved_fds[REDIRECT_MAX_FD + 1]; // file descriptors of the shell changed by the redirections
+
+    // Pass unrecognised commands to the system
+    if (!command) {
+#ifdef DEBUG
+        if (debug) {
+            // Create debug message
+            const char msg[] = "Command '%s' not recognised internally, passing to system shell.";
+            char * dbg_msg;
+
+            // Memory allocation
+            dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(*args) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+            // Output debug message
+            sprintf(dbg_msg, msg, *args);
+            debug_message(dbg_msg);
+        }
+
+#endif // #ifdef DEBUG
+        return process_external_command(args);
+    }
+#ifdef DEBUG
+
+    if (debug) {
+        debug_command_recognised_message(args[0], command->name);
+    }
+#endif // #ifdef DEBUG
+
+    // Check that the command supports the requested options
+    if (proc_info.dont_wait && !(command->capabilities & BUILTIN_BACKGROUND)) {
+        // Create error message
+        const char msg[] = "Command '%s' changes the state of the shell, so it cannot be executed in the background.";
+        char * err_msg;
+
+        // Memory allocation
+        err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(*args) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+        // Output error message
+        sprintf(err_msg, msg, *args);
+        err(err_msg);
+        proc_info.status = JOB_FAILURE_STATUS;
+
+        // Return an exit status indicating to the shell that it should continue executing
+        return EXIT_STATUS_CONTINUE;
+    }
+    if (is_redirected(&redirects, STDIN_FILENO) && !(command->capabilities & BUILTIN_INPUT)) {
+        err("Input redirection is not supported for this command. Ignoring this parameter.");
+        redirect_forget(&redirects, STDIN_FILENO);
+    }
+    if (is_redirected(&redirects, STDOUT_FILENO) && !(command->capabilities & BUILTIN_OUTPUT)) {
+        err("Output redirection is not supported for this command. Ignoring this parameter.");
+        redirect_forget(&redirects, STDOUT_FILENO);
+    }
+
+    // Execute the command in the background as a job of the shell
+    if (proc_info.dont_wait) {
+        if ((proc_info.pid = launch_internal_command(args, -1, -1, -1, job_process_group(0))) > 0) {
+            wait_for_process();
+        }
+
+        // Return an exit status indicating to the shell that it should continue executing
+        return EXIT_STATUS_CONTINUE;
+    }
+
+    // The command is executed by the shell itself, so the redirections are applied to the shell around it
+    redirect_apply(&redirects, saved_fds);
+    return_val = command->function(args + 1 /* the arguments following the command */, &shell_output);
+    redirect_restore(&redirects, saved_fds);
+#ifdef DEBUG
+
+    if (debug) {
+        debug_command_executed_message(args[0], command->name);
+    }
+#endif // #ifdef DEBUG
+
+    return return_val;
+}
+
+/*
+ * Build the index used by find_builtin. This must be called once before any
+ * command is executed.
+ */
+void builtin_setup(void) {
+    int i; // index of the current internal command
+
+    for (i = 0; i < 256; ++i) {
+        builtin_first[i] = -1;
+    }
+
+    // Add the internal commands in reverse, so that each chain is in table order
+    for (i = (int) NUM_BUILTINS - 1; i >= 0; --i) {
+        builtin_next[i] = builtin_first[(unsigned char) *builtins[i].command];
+        builtin_first[(unsigned char) *builtins[i].command] = i;
+    }
+}
+
+/*
+ * Find an internal command. Only the internal commands which start with the
+ * same character as the command are compared.
+ *
+ * PARAMETERS
+ *     command: A null-terminated string containing the command.
+ *
+ * RETURN VALUE
+ * A pointer to the entry for the internal command, or null if the command is
+ * not an internal command.
+ */
+const builtin * find_builtin(const char * command) {
+    for (int i = builtin_first[(unsigned char) *command]; i >= 0; i = builtin_next[i]) {
+        if (!strcmp(command, builtins[i].command)) {
+            return &builtins[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * This function outputs to the terminal a prompt indicating that the shell is
+ * waiting for user input.
+ *
+ * PARAMETERS
+ *     path: A null-terminated string containing the path that will appear in
+ *         the shell prompt.
+ */
+void output_shell_prompt(const char * path) {
+    char * prompt; // the shell prompt to display
+
+    // Allocate space for shell prompt
+#ifdef DEBUG
+    prompt = (char *) arena_alloc(&line_arena, (size_t) ((strlen(DEBUG_PROMPT) + strlen(path) + strlen(PROMPT_SUFFIX) + 1 /* for null character */) * sizeof(char))); // allocate memory for prompt from the line arena
+#else
+    prompt = (char *) arena_alloc(&line_arena, (size_t) ((strlen(path) + strlen(PROMPT_SUFFIX) + 1 /* for null character */) * sizeof(char))); // allocate memory for prompt from the line arena
+#endif // #ifdef DEBUG
+
+    // Generate the shell prompt
+#ifdef DEBUG
+    if (debug) {
+        sprintf(prompt, "%s%s%s", DEBUG_PROMPT, path, PROMPT_SUFFIX);
+    } else {
+        sprintf(prompt, "%s%s", path, PROMPT_SUFFIX);
+    }
+#else
+    sprintf(prompt, "%s%s", path, PROMPT_SUFFIX);
+#endif // #ifdef DEBUG
+
+    // Write prompt
+    writer_puts(&shell_output, prompt);
+}
+
+/*
+ * This function passes an unrecognised command to the system for processing.
+ * If the command is the last that the shell will execute (and runs in the
+ * foreground with no other job left to wait for), the shell is replaced by the
+ * command rather than creating a child process and waiting for it.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int process_external_command(char ** args) {
+    // Replace the shell with the command if the shell has nothing left to do after it
+    if (replace_last && proc_info.last && !proc_info.dont_wait && !jobs_pending()) {
+        return replace_shell(args, TRUE);
+    }
+
+    // Launch the command in a child process
+    if ((proc_info.pid = launch_command(args, -1, -1, job_process_group(0))) > 0) {
+        wait_for_process();
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Launch an external command in a child process, finding the full path to the
+ * command with path_cache_lookup. An error message is displayed if the command
+ * cannot be launched.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *     input_fd: The file descriptor to be used as stdin by the child process,
+ *         or -1 if stdin should not be redirected.
+ *     output_fd: The file descriptor to be used as stdout by the child process,
+ *         or -1 if stdout should not be redirected.
+ *     pgid: The process group for the child process (see launch_program).
+ *
+ * RETURN VALUE
+ * The process ID of the child process, or -1 if the command could not be
+ * launched.
+ */
+pid_t launch_command(char ** args, const int input_fd, const int output_fd, const pid_t pgid) {
+    const char * file; // the full path to the command
+    pid_t pid = -1; // process ID of the child process
+
+    // Make sure that previous output appears before the output of the command
+    writer_flush(&shell_output);
+
+    if ((file = path_cache_lookup(*args)) && ((pid = launch_program(file, args, input_fd, output_fd, pgid)) < 0) && (errno == ENOENT) && (file != *args)) {
+        // The remembered path no longer exists, so forget it and search PATH again
+        path_cache_remove(*args);
+        if ((file = path_cache_lookup(*args))) {
+            pid = launch_program(file, args, input_fd, output_fd, pgid);
+        }
+    }
+
+    if (!file) {
+        errno = ENOENT;
+    }
+
+    if (pid < 0) {
+        // Record the failure as the status of the command
+        proc_info.status = W_EXITCODE((errno == ENOENT) ? LAUNCH_NOT_FOUND_STATUS : LAUNCH_FAILED_STATUS, 0);
+        error_launch(*args);
+    }
+
+    return pid;
+}
+
+/*
+ * Launch an internal command in a child process, so that it can run at the
+ * same time as the other commands of a pipeline (or in the background). The
+ * exit status of the child process is the status of the command.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *     input_fd: The file descriptor to be used as stdin by the child process,
+ *         or -1 if stdin should not be redirected.
+ *     output_fd: The file descriptor to be used as stdout by the child process,
+ *         or -1 if stdout should not be redirected.
+ *     unused_fd: A file descriptor which should be closed by the child
+ *         process, or -1.
+ *     pgid: The process group for the child process (see launch_program).
+ *
+ * RETURN VALUE
+ * The process ID of the child process.
+ */
+pid_t launch_internal_command(char ** args, const int input_fd, const int output_fd, const int unused_fd, const pid_t pgid) {
+    pid_t pid; // process ID of the child process
+
+    // Make sure that buffered output is not duplicated in the child process
+    writer_flush(&shell_output);
+
+    // Fork the current process
+    switch (pid = fork()) {
+        case -1: // fork failed
+            sys_err("fork");
+            break;
+
+        case 0: // child
+            job_child_setup(pgid, !proc_info.dont_wait);
+
+            // Redirect input if necessary
+            if (input_fd >= 0) {
+                dup2(input_fd, STDIN_FILENO);
+                close(input_fd);
+            }
+
+            // Redirect output if necessary
+            if (output_fd >= 0) {
+                dup2(output_fd, STDOUT_FILENO);
+                close(output_fd);
+            }
+
+            if (unused_fd >= 0) {
+                close(unused_fd);
+            }
+
+            // A command in the background must not use the terminal (see help)
+            if (proc_info.dont_wait) {
+                interactive = FALSE;
+            }
+            proc_info.dont_wait = FALSE;
+            proc_info.status = 0;
+
+            execute_command(args);
+            writer_flush(&shell_output);
+            _exit(job_exit_status(proc_info.status));
+
+        default: // parent
+            job_parent_setup(pid, pgid);
+    }
+
+    return pid;
+}
+
+/*
+ * Count the number of pipe characters (defined in strings.h) in an argument
+ * array.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * The number of pipe characters found.
+ */
+unsigned int count_pipes(char ** args) {
+    unsigned int count = 0; // number of pipe characters found
+
+    while (*args) {
+        if (is_pipe(*args++)) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Check whether an argument is the pipe character (defined in strings.h). A
+ * quoted pipe character is not recognised.
+ *
+ * PARAMETERS
+ *     arg: An argument returned by lexer_next.
+ *
+ * RETURN VALUE
+ * TRUE if the argument is the pipe character, otherwise FALSE.
+ */
+boolean is_pipe(const char * arg) {
+    return is_unquoted(arg) && (strlen(arg) == 1) && (arg[0] == PIPE_CHARACTER);
+}
+
+/*
+ * Check whether an argument is an operator which separates the commands of a
+ * command list (defined in strings.h). A quoted operator is not recognised.
+ *
+ * PARAMETERS
+ *     arg: An argument returned by lexer_next.
+ *
+ * RETURN VALUE
+ * TRUE if the argument is a command list operator, otherwise FALSE.
+ */
+boolean is_list_operator(const char * arg) {
+    return is_unquoted(arg) && (!strcmp(arg, SEQUENCE_OPERATOR) || !strcmp(arg, AND_OPERATOR) || !strcmp(arg, OR_OPERATOR));
+}
+
+/*
+ * Check whether a command is an internal command.
+ *
+ * PARAMETERS
+ *     command: A null-terminated string containing the command.
+ *
+ * RETURN VALUE
+ * TRUE if the command is an internal command, otherwise FALSE.
+ */
+boolean is_internal_command(const char * command) {
+    return find_builtin(command) != NULL;
+}
+
+/*
+ * Execute a pipeline of commands, separated by the pipe character (defined in
+ * strings.h). The standard output of each command is connected to the standard
+ * input of the next command, and all commands run at the same time. Each
+ * command may have redirections of its own, which are applied after its pipes
+ * have been connected (so "2>&1" sends stderr into the pipe, and "> file"
+ * replaces it). A command whose redirections fail is not executed.
+ *
+ * Internal commands are executed in a child process, except for the last
+ * command of a pipeline which is not executed in the background.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int process_pipeline(char ** args) {
+    char ** stage = args; // the first argument of the current command
+    char ** arg; // working pointer through arguments
+    pid_t * pids; // process IDs of the commands
+    unsigned int num_stages = count_pipes(args) + 1; // number of commands in the pipeline
+    unsigned int num_pids = 0; // number of commands launched in a child process
+    int input_fd = -1; // stdin of the current command
+    int output_fd; // stdout of the current command
+    int pipe_fds[2] = {-1, -1}; // pipe between the current command and the next command
+    boolean last; // is this the last command of the pipeline?
+    pid_t pgid; // process group of the current command
+    int return_val = EXIT_STATUS_CONTINUE; // return value of the last command
+    int status = -1; // status of the last command, if it was executed by the shell itself (otherwise -1)
+
+    // Make sure that no command is empty
+    for (arg = args; *arg; arg++) {
+        if (is_pipe(*arg) && ((arg == args) || is_pipe(*(arg - 1)) || !*(arg + 1))) {
+            const char pipe_string[2] = {PIPE_CHARACTER, '\0'};
+            error_no_argument(pipe_string);
+            return EXIT_STATUS_CONTINUE;
+        }
+    }
+
+    // Memory allocation
+    pids = (pid_t *) arena_alloc(&line_arena, (size_t) (num_stages * sizeof(pid_t))); // allocate memory for pids from the line arena
+
+    for (unsigned int i = 0; i < num_stages; ++i) {
+        // Find the end of this command
+        for (arg = stage; *arg && !is_pipe(*arg); arg++);
+        last = (*arg == NULL);
+        *arg = NULL;
+
+        // Connect this command to the next command
+        if (!last) {
+            if (pipe2(pipe_fds, O_CLOEXEC)) sys_err("pipe2"); // attempt to create a pipe
+            output_fd = pipe_fds[1];
+        } else {
+            pipe_fds[0] = -1;
+            output_fd = -1;
+        }
+
+        if (redirect_parse(&redirects, stage) && *stage) {
+#ifdef DEBUG
+            if (debug) {
+                // Create debug message
+                const char msg[] = "Launching command %u of %u in pipeline: '%s'.";
+                char * dbg_msg;
+
+                // Memory allocation
+                dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + digits(i + 1) + digits(num_stages) + strlen(*stage) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+                // Output debug message
+                sprintf(dbg_msg, msg, i + 1, num_stages, *stage);
+                debug_message(dbg_msg);
+            }
+
+#endif // #ifdef DEBUG
+            // Every command of the pipeline joins the process group of the first child process
+            pgid = job_process_group(num_pids ? pids[0] : 0);
+
+            if (is_internal_command(*stage)) {
+                if (last && !proc_info.dont_wait) {
+                    // Execute the last command in the shell (internal commands do not read stdin)
+                    return_val = execute_command(stage);
+                    status = proc_info.status;
+                } else {
+                    pids[num_pids++] = launch_internal_command(stage, input_fd, output_fd, pipe_fds[0], pgid);
+                }
+            } else if ((proc_info.pid = launch_command(stage, input_fd, output_fd, pgid)) > 0) {
+                pids[num_pids++] = proc_info.pid;
+            }
+        }
+        redirect_close(&redirects);
+
+        // The pipes now belong to the child processes
+        if (i > 0) {
+            close(input_fd);
+        }
+        if (!last) {
+            close(pipe_fds[1]);
+        }
+
+        input_fd = pipe_fds[0];
+        stage = arg + 1;
+    }
+
+    wait_for_processes(pids, num_pids);
+
+    // The status of the pipeline is that of its last command
+    if (status >= 0) {
+        proc_info.status = status;
+    }
+
+    return return_val;
+}
+
+/*
+ * This function and look at the last argument for the don't wait character
+ * (defined in strings.h). Upon finding the don't wait character, the function
+ * will set a flag and set this argument to NULL.
+ *
+ * Note that the don't wait character should be the last argument of the
+ * argument array. No check is made for this, but all arguments after the don't
+ * wait character will be ignored.
+ *
+ * PARAMETERS
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null element.
+*/
+void check_for_dont_wait(char ** args) {
+    char ** arg = args; // working pointer through args
+    unsigned int count_args = 0; // number of arguments
+
+    // Count arguments
+    while (*arg++) {
+        count_args++;
+    }
+
+    // arg now points to the element AFTER the last null element
+
+    if (count_args >= 1) {
+        arg = arg - 2; // point arg to the last argument of the array
+
+#ifdef DEBUG
+        if (debug) {
+            // Create debug message
+            const char msg[] = "Checking for don't wait character '%c'.";
+            char * dbg_msg;
+
+            // Memory allocation
+            dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + 1 /* for dont wait character */ + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+            // Output debug message
+            sprintf(dbg_msg, msg, DONT_WAIT_CHARACTER);
+            debug_message(dbg_msg);
+        }
+
+#endif // #ifdef DEBUG
+        // Check for dont_wait character
+        if (is_unquoted(*arg) && (strlen(*arg) == 1) && ((*arg)[0] == DONT_WAIT_CHARACTER)) {
+#ifdef DEBUG
+            if (debug) {
+                // Create debug message
+                const char msg[] = "Found the character '%c'. This command will be executed in the background.";
+                char * dbg_msg;
+
+                // Memory allocation
+                dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + 1 /* for dont wait character */ + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+                // Output debug message
+                sprintf(dbg_msg, msg, DONT_WAIT_CHARACTER);
+                debug_message(dbg_msg);
+            }
+
+#endif // #ifdef DEBUG
+            proc_info.dont_wait = TRUE; // set the don't wait flag
+
+#ifdef DEBUG
+            if (debug) {
+                // Create debug message
+                const char msg[] = "Removing '%c' from argument list.";
+                char * dbg_msg;
+
+                // Memory allocation
+                dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + 1 /* for dont wait character */ + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+                // Output debug message
+                sprintf(dbg_msg, msg, DONT_WAIT_CHARACTER);
+                debug_message(dbg_msg);
+            }
+
+#endif // #ifdef DEBUG
+            // Remove argument from array
+            *(array_movetoend(arg)) = 0;
+        }
+    }
+#ifdef DEBUG
+    else {
+        // Not enough arguments
+        if (debug) {
+            debug_message("Not enough arguments for there to be a don't wait character. Skipping this check.");
+        }
+    }
+#endif // #ifdef DEBUG
+}
+
+/*
+ * Display an error message that a command requiring an argument has been
+ * executed without an argument.
+ *
+ * PARAMETERS
+ *     command: A null-terminated string containing the command for which
+ *         arguments were required but not specified.
+ */
+void error_no_argument(const char * command) {
+    // Create error message
+    const char msg[] = "No argument found for command '%s'.";
+    char * err_msg;
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(command) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, command);
+    err(err_msg);
+    proc_info.status = JOB_FAILURE_STATUS;
+}
+
+/*
+ * Display an error message that a command has been specified with an unknown
+ * argument.
+ *
+ * PARAMETERS
+ *     command: A null-terminated string containing the command for which an
+ *         argument was unrecognised.
+ *     arg: A null-terminated string containing the unrecognised argument.
+ */
+void error_unrecognised_argument(const char * command, const char * arg) {
+    // Create error message
+    const char msg[] = "Unrecognised argument to command '%s': '%s'.";
+    char * err_msg;
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(command) + strlen(arg) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, command, arg);
+    err(err_msg);
+    proc_info.status = JOB_FAILURE_STATUS;
+}
+
+/*
+ * Reset the process information.
+ */
+void reset_process_information(void) {
+    // Reset process information
+    proc_info.pid = 0;
+    proc_info.dont_wait = FALSE; // by default, run commands in the foreground
+    proc_info.status = 0;
+    proc_info.last = FALSE;
+    proc_info.command = NULL;
+}
+
+#ifdef DEBUG
+/*
+ * Turns debug mode on or off.
+ *
+ * PARAMETERS
+ *     args: The arguments to the command. The first argument must be DEBUG_ON
+ *         or DEBUG_OFF (defined in strings.h).
+ *     out: The writer to which the output of the command is written (unused).
+ *
+ * RETURN VALUE
+ * An exit status indicating to the shell what action should be taken.
+ */
+int debug_mode(char ** args, writer * out) {
+    (void) out; // debug messages are written to the output of the shell
+    // Check for arguments
+    if (!*args) {
+        error_no_argument(DEBUG_COMMAND);
+    } else if (!strcmp(*args, DEBUG_ON)) {
+        // Turn debug mode on
+        debug = TRUE;
+        debug_message("Debug mode on.");
+    } else if (!strcmp(*args, DEBUG_OFF)) {
+        // Turn debug mode off
+        debug = FALSE;
+        debug_message("Debug mode off.");
+    } else {
+        error_unrecognised_argument(DEBUG_COMMAND, *args);
+    }
+
+    // Return an exit status indicating to the shell that it should continue executing
+    return EXIT_STATUS_CONTINUE;
+}
+
+/*
+ * Display a debug message indicating that a command has been recognised.
+ *
+ * PARAMETERS
+ *     command: The command that was recognised.
+ *     command_name: The full name of the command that was recognised.
+ */
+void debug_command_recognised_message(const char * command, const char * command_name) {
+    // Create debug message
+    const char msg[] = "%s command '%s' recognised.";
+    char * dbg_msg;
+
+    // Memory allocation
+    dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(command) + strlen(command_name) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+    // Output debug message
+    sprintf(dbg_msg, msg, command_name, command);
+    debug_message(dbg_msg);
+}
+
+/*
+ * Display a debug message indicating that a command has been executed.
+ *
+ * PARAMETERS
+ *     command:         The command that was executed.
+ *     command_name:    The full name of the command that was executed.
+ */
+void debug_command_executed_message(const char * command, const char * command_name) {
+    // Create debug message
+    const char msg[] = "%s command '%s' executed.";
+    char * dbg_msg;
+
+    // Memory allocation
+    dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(command) + strlen(command_name) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+    // Output debug message
+    sprintf(dbg_msg, msg, command_name, command);
+    debug_message(dbg_msg);
+}
+
+/*
+ * Display a debug message showing the input that has been read.
+ *
+ * PARAMETERS
+ *     buffer: The text that has been read (which need not be null-terminated).
+ *     length: The length of the text.
+ */
+void debug_read_line_message(const char * buffer, size_t length) {
+    // Create debug message
+    const char msg[] = "Read line: '%.*s'.";
+    char * dbg_msg;
+
+    // Don't print the new-line character
+    if (length && (buffer[length - 1] == '\n')) {
+        length--;
+    }
+
+    // Memory allocation
+    dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + length + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+    // Output debug message
+    sprintf(dbg_msg, msg, (int) length, buffer);
+    debug_message(dbg_msg);
+}
+
+/*
+ * Display a debug message showing the command and arguments that have been
+ * recognised and will be processed.
+ *
+ * PARAMETERS
+ *     command: The command that will be processed.
+ *     args: A pointer to the first argument that will be processed.
+ */
+void debug_command_args_message(const char * command, const char ** args) {
+    const char ** arg = args; // working pointer through arguments
+    size_t size = 0; // current size of dbg_msg
+
+    // Create debug message
+    const char msg[] = "Command '%s' was input.\n";
+    const char args_msg[] = "%sArgument %d: '%s'\n";
+    char * dbg_msg;
+
+    // Memory allocation
+    dbg_msg = (char *) arena_alloc(&line_arena, (size_t) (size += ((strlen(msg) + strlen(command) + 1 /* for null character */) * sizeof(char)))); // allocate memory for dbg_msg from the line arena
+
+    // Output debug message
+    sprintf(dbg_msg, msg, command);
+    unsigned int i = 1;
+    arg = args;
+    while (*(++arg)) {
+        char * previous = dbg_msg; // the debug message so far
+
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) (size += ((strlen(args_msg) + digits(i) + strlen(*arg)) * sizeof(char)))); // allocate memory for dbg_msg from the line arena
+        sprintf(dbg_msg, args_msg, previous, i++, *arg);
+    }
+    debug_message(dbg_msg);
+}
+
+/*
+ * Display a debug message showing how much memory was allocated from an arena
+ * since it was last reset.
+ *
+ * PARAMETERS
+ *     a: The arena.
+ */
+void debug_arena_message(const arena * a) {
+    // Create debug message
+    const char msg[] = "Line arena: %lu allocations (%lu bytes), %lu heap allocations (%lu in total).";
+    char * dbg_msg;
+
+    // Memory allocation
+    dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + 4 * 20 /* for numbers */ + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+    // Output debug message
+    sprintf(dbg_msg, msg, a->allocations, (unsigned long) a->bytes, a->heap_allocations, a->total_heap_allocations);
+    debug_message(dbg_msg);
+}
+#endif // #ifdef DEBUG
@@ -0,0 +1,316 @@
+/*
+ * pager.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to display the manual for the shell
+ * without executing another program.
+ *
+ * The manual is memory mapped the first time that it is required and remains
+ * mapped for the lifetime of the shell. When it is mapped, an index of its
+ * headings (lines beginning with an upper case letter) and of the entries for
+ * each command (lines in the MANUAL_COMMANDS_HEADING section indented by
+ * MANUAL_ENTRY_INDENT spaces) is built, so that a single section can be
+ * displayed.
+ */
+
+#include "../inc/pager.h"
+
+/*
+ * Memory map the manual and index its sections. The manual is only mapped the
+ * first time that this function is called.
+ *
+ * PARAMETERS
+ *     home: The path to the home directory, which should contain the readme
+ *         file.
+ *
+ * RETURN VALUE
+ * A pointer to the manual on success. On failure, null is returned and errno
+ * is set to indicate the error.
+ */
+const manual_file * manual_load(const char * home) {
+    static manual_file manual; // the manual
+    static boolean loaded = FALSE; // has the manual been mapped?
+    char * readme; // path to the readme file
+    struct stat info; // information about the readme file
+    void * data; // the memory mapped readme file
+    int fd; // file descriptor of the readme file
+    int error; // error number to report
+
+    if (loaded) {
+        return &manual;
+    }
+
+    // Memory allocation
+    if (!(readme = (char *) malloc((size_t) ((strlen(home) + 1 /* for slash */ + strlen(README_PATH) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for readme
+
+    // Find the readme file in the home directory
+    sprintf(readme, "%s/%s", home, README_PATH);
+    fd = open(readme, O_RDONLY | O_CLOEXEC);
+    error = errno;
+    free(readme);
+
+    if (fd < 0) {
+        errno = error;
+        return NULL;
+    }
+
+    if (fstat(fd, &info)) {
+        error = errno;
+        close(fd);
+        errno = error;
+        return NULL;
+    }
+
+    if (info.st_size) {
+        if ((data = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+            error = errno;
+            close(fd);
+            errno = error;
+            return NULL;
+        }
+        manual.data = (const char *) data;
+    } else {
+        manual.data = "";
+    }
+    close(fd); // the mapping remains valid after the file is closed
+
+    manual.size = (size_t) info.st_size;
+    manual_index(&manual);
+    loaded = TRUE;
+
+    return &manual;
+}
+
+/*
+ * Index the headings and command entries of the manual.
+ *
+ * PARAMETERS
+ *     manual: The manual to index.
+ */
+void manual_index(manual_file * manual) {
+    const char * line = manual->data; // the current line
+    const char * end = manual->data + manual->size; // end of the manual
+    const char * next; // the line after the current line
+    const char * name_end; // end of the name of a section
+    unsigned int capacity = 0; // current capacity of the index
+    int heading = -1; // index of the current heading
+    int command = -1; // index of the current command entry
+    boolean in_commands = FALSE; // is the current line in the MANUAL_COMMANDS_HEADING section?
+    unsigned int indent; // indentation of the current line
+
+    manual->sections = NULL;
+    manual->num_sections = 0;
+
+    while (line < end) {
+        if (!(next = memchr(line, '\n', (size_t) (end - line)))) {
+            next = end;
+        } else {
+            next++;
+        }
+
+        indent = 0;
+        while ((line + indent < next) && (line[indent] == ' ')) {
+            indent++;
+        }
+
+        if (isupper((unsigned char) *line) || (in_commands && (indent == MANUAL_ENTRY_INDENT) && !isspace((unsigned char) line[indent]))) {
+            // A new section starts at this line, ending the current command entry
+            if (command >= 0) {
+                manual->sections[command].end = line;
+                command = -1;
+            }
+
+            // Memory allocation
+            if (manual->num_sections == capacity) {
+                capacity = capacity ? capacity * 2 : 32;
+                if (!(manual->sections = (manual_section *) realloc(manual->sections, (size_t) (capacity * sizeof(manual_section))))) sys_err("realloc"); // attempt to reallocate memory for sections
+            }
+
+            if (indent) {
+                // Command entry, named by its first word
+                name_end = line + indent;
+                while ((name_end < next) && !isspace((unsigned char) *name_end)) {
+                    name_end++;
+                }
+                command = (int) manual->num_sections;
+                manual->sections[command].is_command = TRUE;
+            } else {
+                // Heading, ending the current heading
+                if (heading >= 0) {
+                    manual->sections[heading].end = line;
+                }
+
+                name_end = next;
+                while ((name_end > line) && isspace((unsigned char) *(name_end - 1))) {
+                    name_end--;
+                }
+                heading = (int) manual->num_sections;
+                manual->sections[heading].is_command = FALSE;
+                in_commands = ((size_t) (name_end - line) == strlen(MANUAL_COMMANDS_HEADING)) && !strncmp(line, MANUAL_COMMANDS_HEADING, strlen(MANUAL_COMMANDS_HEADING));
+            }
+
+            manual->sections[manual->num_sections].name = line + indent;
+            manual->sections[manual->num_sections].name_length = (size_t) (name_end - (line + indent));
+            manual->sections[manual->num_sections].start = line;
+            manual->sections[manual->num_sections].end = end;
+            manual->num_sections++;
+        } else if ((command >= 0) && !isspace((unsigned char) line[indent]) && (indent < MANUAL_ENTRY_INDENT)) {
+            // Text which is less indented than a command entry ends that entry
+            manual->sections[command].end = line;
+            command = -1;
+        }
+
+        line = next;
+    }
+
+    // Sections which are still open end at the end of the manual
+    if (heading >= 0) {
+        manual->sections[heading].end = end;
+    }
+    if (command >= 0) {
+        manual->sections[command].end = end;
+    }
+}
+
+/*
+ * Find a section of the manual. The entry for a command with exactly the same
+ * name is preferred, otherwise the first heading containing the topic
+ * (ignoring case) is found.
+ *
+ * PARAMETERS
+ *     manual: The manual to search.
+ *     topic: A null-terminated string containing the topic to search for.
+ *
+ * RETURN VALUE
+ * A pointer to the section, or null if no section was found.
+ */
+const manual_section * manual_find(const manual_file * manual, const char * topic) {
+    const size_t length = strlen(topic); // length of the topic
+
+    // Look for a command
+    for (unsigned int i = 0; i < manual->num_sections; ++i) {
+        if (manual->sections[i].is_command && (manual->sections[i].name_length == length) && !strncmp(manual->sections[i].name, topic, length)) {
+            return &manual->sections[i];
+        }
+    }
+
+    // Look for a heading
+    for (unsigned int i = 0; i < manual->num_sections; ++i) {
+        if (manual->sections[i].is_command || (manual->sections[i].name_length < length)) {
+            continue;
+        }
+        for (size_t offset = 0; offset + length <= manual->sections[i].name_length; ++offset) {
+            if (!strncasecmp(manual->sections[i].name + offset, topic, length)) {
+                return &manual->sections[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Display text. If paging is requested, the text is displayed one screen at a
+ * time and the user is prompted (with PAGER_PROMPT) between screens. Otherwise
+ * the text is output with a single write.
+ *
+ * PARAMETERS
+ *     text: The text to display.
+ *     length: The length of the text.
+ *     fd: The file descriptor to display the text on.
+ *     paged: Should the text be displayed one screen at a time?
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned and errno is set to indicate the
+ * error.
+ */
+int page(const char * text, const size_t length, const int fd, const boolean paged) {
+    const char * end = text + length; // end of the text
+    const char * screen_end; // end of the text to be displayed on this screen
+    struct winsize size; // size of the terminal
+    unsigned int rows = PAGER_DEFAULT_ROWS; // number of rows in the terminal
+    unsigned int lines; // number of lines to display before the next prompt
+    int key; // the key pressed at the prompt
+
+    if (!paged) {
+        return write_all(fd, text, length);
+    }
+
+    if (!ioctl(fd, TIOCGWINSZ, &size) && (size.ws_row > 1)) {
+        rows = size.ws_row;
+    }
+
+    lines = rows - 1; // leave a row for the prompt
+    while (text < end) {
+        // Find the end of this screen
+        screen_end = text;
+        for (unsigned int i = 0; (i < lines) && (screen_end < end); ++i) {
+            if (!(screen_end = memchr(screen_end, '\n', (size_t) (end - screen_end)))) {
+                screen_end = end;
+            } else {
+                screen_end++;
+            }
+        }
+
+        if (write_all(fd, text, (size_t) (screen_end - text))) {
+            return -1;
+        }
+        text = screen_end;
+
+        if (text < end) {
+            // Prompt for the next screen
+            if (write_all(fd, PAGER_PROMPT, strlen(PAGER_PROMPT))) {
+                return -1;
+            }
+            key = pager_wait_for_key();
+            if (write_all(fd, "\r\033[K", 4 /* carriage return and erase line */)) {
+                return -1;
+            }
+
+            if ((key == EOF) || (key == PAGER_QUIT_CHARACTER)) {
+                break;
+            }
+            lines = (key == PAGER_LINE_CHARACTER) ? 1 : rows - 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Wait for a key to be pressed at the terminal. Terminal echo and canonical
+ * mode are turned off while waiting.
+ *
+ * RETURN VALUE
+ * The key that was pressed, or EOF if the terminal could not be read.
+ */
+int pager_wait_for_key(void) {
+    struct termios old; // structure containing old terminal information
+    struct termios new; // structure containing new terminal information
+    unsigned char key; // the key pressed
+    int fd; // file descriptor of the terminal
+    int result = EOF; // the key pressed (or EOF)
+
+    if ((fd = open(ctermid(NULL), O_RDONLY | O_CLOEXEC)) < 0) {
+        return EOF;
+    }
+
+    if (!tcgetattr(fd, &old)) {
+        new = old;
+        new.c_lflag &= ~(ECHO | ECHOE | ECHOK | ECHONL | ICANON);
+        new.c_cc[VMIN] = 1;
+        new.c_cc[VTIME] = 0;
+
+        if (!tcsetattr(fd, TCSAFLUSH, &new)) {
+            if (read(fd, &key, 1) == 1) {
+                result = key;
+            }
+            tcsetattr(fd, TCSAFLUSH, &old); // restore the terminal state
+        }
+    }
+    close(fd);
+
+    return result;
+}
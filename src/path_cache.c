@@ -0,0 +1,285 @@
+/*
+ * path_cache.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains a hash table which remembers the full path to each
+ * external command, so that the directories in the PATH environment variable
+ * need not be searched every time a command is executed.
+ *
+ * Commands which could not be found are remembered as well (with a null path),
+ * so that repeatedly executing a missing command does not search PATH again.
+ * Such an entry is only trusted for PATH_CACHE_NOT_FOUND_SECONDS, after which
+ * PATH is searched again, so that a command installed later is found. The
+ * whole table is forgotten whenever the value of PATH changes.
+ */
+
+#include "../inc/path_cache.h"
+
+path_cache_entry * path_cache[PATH_CACHE_BUCKETS]; // the hash table
+char * path_cache_path; // the value of PATH when the hash table was filled
+
+/*
+ * Calculate the hash of a command name (FNV-1a).
+ *
+ * PARAMETERS
+ *     name: A null-terminated string containing the command name.
+ *
+ * RETURN VALUE
+ * The bucket in which the command belongs.
+ */
+unsigned int path_cache_hash(const char * name) {
+    unsigned int hash = 2166136261u; // FNV offset basis
+
+    while (*name) {
+        hash ^= (unsigned char) *name++;
+        hash *= 16777619u; // FNV prime
+    }
+
+    return hash & (PATH_CACHE_BUCKETS - 1);
+}
+
+/*
+ * Search the directories in PATH for a command.
+ *
+ * The memory allocated by this function must be freed by the caller.
+ *
+ * PARAMETERS
+ *     name: A null-terminated string containing the command name.
+ *     search_path: A null-terminated string containing a colon separated list
+ *         of directories to search.
+ *
+ * RETURN VALUE
+ * A pointer to a null-terminated string containing the full path to the
+ * command, or null if the command could not be found.
+ */
+char * path_cache_search(const char * name, const char * search_path) {
+    const char * dir = search_path; // current directory of search_path
+    const char * end; // end of the current directory
+    size_t length; // length of the current directory
+    char * candidate = NULL; // the full path to check
+    struct stat info; // information about the candidate
+
+    do {
+        // Find the end of this directory
+        if (!(end = strchr(dir, ':'))) {
+            end = dir + strlen(dir);
+        }
+        length = (size_t) (end - dir);
+
+        // Memory allocation
+        if (!(candidate = (char *) realloc(candidate, (size_t) ((length + 2 /* for './' */ + strlen(name) + 1 /* for null character */) * sizeof(char))))) sys_err("realloc"); // attempt to reallocate memory for candidate
+
+        // An empty directory refers to the current working directory
+        if (length) {
+            sprintf(candidate, "%.*s/%s", (int) length, dir, name);
+        } else {
+            sprintf(candidate, "./%s", name);
+        }
+
+        // Check for an executable regular file
+        if (!stat(candidate, &info) && S_ISREG(info.st_mode) && !access(candidate, X_OK)) {
+            return candidate;
+        }
+
+        dir = end + 1;
+    } while (*end);
+
+    // Clean up
+    free(candidate);
+
+    return NULL;
+}
+
+/*
+ * Find the full path to a command which is about to be executed, counting the
+ * use in the hits of the command (see path_cache_find).
+ *
+ * PARAMETERS
+ *     name: A null-terminated string containing the command name.
+ *
+ * RETURN VALUE
+ * A pointer to a null-terminated string containing the full path to the
+ * command, or null if the command could not be found. The string belongs to
+ * the hash table and must not be freed by the caller.
+ */
+const char * path_cache_lookup(const char * name) {
+    path_cache_entry * entry; // the entry of the command
+
+    if (strchr(name, '/')) {
+        return name;
+    }
+
+    entry = path_cache_get(name);
+    entry->hits++;
+
+    return entry->path;
+}
+
+/*
+ * Find the full path to a command, without counting it as a use of the
+ * command. Commands containing a slash character are returned unchanged.
+ * Otherwise the hash table is used, and PATH is only searched if the command
+ * has not been seen before.
+ *
+ * PARAMETERS
+ *     name: A null-terminated string containing the command name.
+ *
+ * RETURN VALUE
+ * A pointer to a null-terminated string containing the full path to the
+ * command, or null if the command could not be found. The string belongs to
+ * the hash table and must not be freed by the caller.
+ */
+const char * path_cache_find(const char * name) {
+    if (strchr(name, '/')) {
+        return name;
+    }
+
+    return path_cache_get(name)->path;
+}
+
+/*
+ * Get the entry of a command in the hash table, adding it (and searching PATH
+ * for the command) if the command has not been seen before.
+ *
+ * PARAMETERS
+ *     name: A null-terminated string containing the command name, which must
+ *         not contain a slash character.
+ *
+ * RETURN VALUE
+ * A pointer to the entry of the command.
+ */
+path_cache_entry * path_cache_get(const char * name) {
+    const char * search_path = variable_get("PATH", strlen("PATH")); // the directories to search
+    path_cache_entry ** bucket; // the bucket in which the command belongs
+    path_cache_entry * entry; // working pointer through bucket
+
+    if (!search_path) {
+        search_path = DEFAULT_PATH;
+    }
+
+    // Forget everything if PATH has changed
+    if (!path_cache_path || strcmp(path_cache_path, search_path)) {
+        path_cache_clear();
+        if (!(path_cache_path = strdup(search_path))) sys_err("strdup"); // attempt to copy PATH
+    }
+
+    // Look for the command in the hash table
+    bucket = &path_cache[path_cache_hash(name)];
+    for (entry = *bucket; entry; entry = entry->next) {
+        if (!strcmp(entry->name, name)) {
+            // Search PATH again if the command was not found some time ago
+            if (!entry->path && (time(NULL) - entry->searched >= PATH_CACHE_NOT_FOUND_SECONDS)) {
+                entry->path = path_cache_search(name, search_path);
+                entry->searched = time(NULL);
+            }
+
+            return entry;
+        }
+    }
+
+#ifdef DEBUG
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Command '%s' not found in hash table. Searching PATH.";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(name) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, name);
+        debug_message(dbg_msg);
+    }
+
+#endif // #ifdef DEBUG
+    // Add a new entry to the hash table
+    if (!(entry = (path_cache_entry *) malloc(sizeof(path_cache_entry)))) sys_err("malloc"); // attempt to allocate memory for entry
+    if (!(entry->name = strdup(name))) sys_err("strdup"); // attempt to copy name
+    entry->path = path_cache_search(name, search_path);
+    entry->searched = time(NULL);
+    entry->hits = 0;
+    entry->next = *bucket;
+    *bucket = entry;
+
+    return entry;
+}
+
+/*
+ * Forget the full path to a single command. This should be used if the
+ * remembered path no longer refers to an executable file.
+ *
+ * PARAMETERS
+ *     name: A null-terminated string containing the command name.
+ */
+void path_cache_remove(const char * name) {
+    path_cache_entry ** entry; // working pointer through the bucket
+    path_cache_entry * removed; // the entry being removed
+
+    for (entry = &path_cache[path_cache_hash(name)]; *entry; entry = &(*entry)->next) {
+        if (!strcmp((*entry)->name, name)) {
+            removed = *entry;
+            *entry = removed->next;
+
+            // Clean up
+            free(removed->name);
+            free(removed->path);
+            free(removed);
+            break;
+        }
+    }
+}
+
+/*
+ * Forget the full path to all commands.
+ */
+void path_cache_clear(void) {
+    path_cache_entry * entry; // working pointer through each bucket
+    path_cache_entry * next; // the entry after entry
+
+    for (unsigned int i = 0; i < PATH_CACHE_BUCKETS; ++i) {
+        for (entry = path_cache[i]; entry; entry = next) {
+            next = entry->next;
+
+            // Clean up
+            free(entry->name);
+            free(entry->path);
+            free(entry);
+        }
+        path_cache[i] = NULL;
+    }
+
+    free(path_cache_path);
+    path_cache_path = NULL;
+}
+
+/*
+ * Print all remembered commands, in the same format as the 'hash' command of
+ * bash.
+ *
+ * PARAMETERS
+ *     out: The writer to print to.
+ */
+void path_cache_print(writer * out) {
+    path_cache_entry * entry; // working pointer through each bucket
+    boolean empty = TRUE; // is the hash table empty?
+
+    for (unsigned int i = 0; i < PATH_CACHE_BUCKETS; ++i) {
+        for (entry = path_cache[i]; entry; entry = entry->next) {
+            if (empty) {
+                writer_puts(out, "hits\tcommand\n");
+                empty = FALSE;
+            }
+            if (entry->path) {
+                writer_printf(out, "%4u\t%s\n", entry->hits, entry->path);
+            } else {
+                writer_printf(out, "%4u\t%s (not found)\n", entry->hits, entry->name);
+            }
+        }
+    }
+
+    if (empty) {
+        writer_puts(out, "hash table empty\n");
+    }
+}
@@ -0,0 +1,461 @@
+/*
+ * pathname.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the expansion of pathname patterns. An argument which
+ * contains GLOB_ANY_STRING, GLOB_ANY_CHARACTER or GLOB_SET_OPEN (outside of
+ * quotation marks) is a pattern, and is replaced by the names of the matching
+ * files in sorted order. A pattern which matches nothing is left unchanged.
+ *
+ * Each part of a pattern between '/' characters is matched against the entries
+ * of a directory. The entries of each directory are read (and sorted) once for
+ * all of the arguments of a command, so that two patterns in the same directory
+ * (such as "*.x" and "*.y") only read the directory once. The directories are
+ * read again for the next command, because earlier commands may have created
+ * or removed files.
+ *
+ * The lexer marks the arguments which contain wildcards (TOKEN_GLOB), so the
+ * arguments of a command without patterns are not examined at all. In such an
+ * argument, a character preceded by GLOB_ESCAPE (such as a quoted wildcard)
+ * only matches itself, and the GLOB_ESCAPE characters are removed from a
+ * pattern which matches nothing.
+ */
+
+#include "../inc/pathname.h"
+
+/*
+ * Expand the pathname patterns in the arguments of a command. Every argument
+ * marked by the lexer with TOKEN_GLOB is replaced by the matching pathnames
+ * (in sorted order), unless nothing matches.
+ *
+ * PARAMETERS
+ *     a: The arena from which to allocate the expanded arguments.
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * A pointer to an array of character strings, terminated by a null entry. This
+ * is args itself if there are no patterns.
+ */
+char ** expand_pathnames(arena * a, char ** args) {
+    pathname_expansion * expansion; // the state of the expansion
+    char ** arg; // working pointer through args
+    unsigned int first; // the first expanded argument of the current argument
+
+    // Check whether there is anything to expand
+    for (arg = args; *arg && !((*arg)[-1] & TOKEN_GLOB); arg++);
+    if (!*arg) {
+        return args;
+    }
+
+    // Memory allocation
+    expansion = (pathname_expansion *) arena_alloc(a, sizeof(pathname_expansion)); // allocate memory for expansion from the arena
+    expansion->memory = a;
+    expansion->directories = NULL;
+    expansion->num_args = 0;
+    expansion->capacity = (unsigned int) (arg - args) + PATHNAME_MATCHES;
+    expansion->args = (char **) arena_alloc(a, (size_t) (expansion->capacity * sizeof(char *))); // allocate memory for the expanded arguments from the arena
+
+    for (arg = args; *arg; arg++) {
+        first = expansion->num_args;
+        if ((*arg)[-1] & TOKEN_GLOB) {
+            pathname_glob(expansion, 0, *arg);
+        }
+
+        if (expansion->num_args == first) {
+            // Keep the argument unchanged (apart from its escapes)
+            if ((*arg)[-1] & TOKEN_GLOB) {
+                remove_escapes(*arg);
+            }
+            pathname_append(expansion, *arg);
+        } else {
+            qsort(expansion->args + first, (size_t) (expansion->num_args - first), sizeof(char *), pathname_compare);
+        }
+    }
+    pathname_append(expansion, NULL);
+
+    return expansion->args;
+}
+
+/*
+ * Find the pathnames which match a pattern, adding each to the expanded
+ * arguments. The part of the pathname which has already been matched is in
+ * expansion->path.
+ *
+ * PARAMETERS
+ *     expansion: The state of the expansion.
+ *     length: The length of the part of the pathname which has already been
+ *         matched.
+ *     pattern: The rest of the pattern.
+ */
+void pathname_glob(pathname_expansion * expansion, size_t length, const char * pattern) {
+    const char * end; // end of the current part of the pattern
+    const pathname_directory * directory; // the directory in which to match the current part
+    struct stat info; // information about a file
+
+    // Copy any '/' characters to the path
+    while (*pattern == '/') {
+        if (length + 1 >= PATH_MAX) {
+            return;
+        }
+        expansion->path[length++] = *pattern++;
+    }
+
+    if (!*pattern) {
+        // A pattern which ends with '/' only matches directories
+        expansion->path[length] = '\0';
+        if (!stat(expansion->path, &info) && S_ISDIR(info.st_mode)) {
+            pathname_add(expansion, expansion->path, length);
+        }
+        return;
+    }
+
+    end = strchrnul(pattern, '/');
+    if (!has_wildcards(pattern, end)) {
+        // Copy a part without wildcards to the path, without its escapes
+        if (length + (size_t) (end - pattern) >= PATH_MAX) {
+            return;
+        }
+        for (const char * p = pattern; p < end; p++) {
+            if ((*p == GLOB_ESCAPE) && (p + 1 < end)) {
+                p++;
+            }
+            expansion->path[length++] = *p;
+        }
+        expansion->path[length] = '\0';
+
+        if (*end) {
+            pathname_glob(expansion, length, end);
+        } else if (!lstat(expansion->path, &info)) {
+            pathname_add(expansion, expansion->path, length);
+        }
+        return;
+    }
+
+    directory = pathname_list(expansion, length);
+    for (unsigned int i = 0; i < directory->num_names; ++i) {
+        const char * name = directory->names[i]; // the current entry
+        const size_t name_length = strlen(name); // length of the name of the entry
+
+        // Hidden files are only matched by a pattern which starts with '.'
+        if (((*name == '.') && (*pattern != '.')) || !wildcard_match(pattern, end, name) || (length + name_length >= PATH_MAX)) {
+            continue;
+        }
+
+        // Only directories (or symbolic links, which may refer to directories) can match a part followed by '/'
+        if (*end && !is_directory_type((unsigned char) name[-1])) {
+            continue;
+        }
+
+        memcpy(expansion->path + length, name, name_length + 1 /* for null character */);
+        if (*end) {
+            pathname_glob(expansion, length + name_length, end);
+        } else {
+            pathname_add(expansion, expansion->path, length + name_length);
+        }
+    }
+}
+
+/*
+ * Get the entries of a directory, in sorted order. The entries of each
+ * directory are only read once during an expansion. The entries '.' and '..'
+ * are never included. If the directory cannot be read, it has no entries. The
+ * byte before each name holds the type of the entry reported by readdir.
+ *
+ * PARAMETERS
+ *     expansion: The state of the expansion.
+ *     length: The length of the directory path at the start of
+ *         expansion->path (0 for the current directory).
+ *
+ * RETURN VALUE
+ * A pointer to the directory.
+ */
+pathname_directory * pathname_list(pathname_expansion * expansion, const size_t length) {
+    pathname_directory * directory; // the directory
+    DIR * dir; // the directory stream
+    struct dirent * entry; // the current entry of the directory
+    char * name; // the type and name of the current entry
+    unsigned int capacity = 0; // number of entries allocated for names
+
+    // Look for a directory which has already been read
+    for (directory = expansion->directories; directory; directory = directory->next) {
+        if ((strlen(directory->path) == length) && !memcmp(directory->path, expansion->path, length)) {
+            return directory;
+        }
+    }
+
+    // Memory allocation
+    directory = (pathname_directory *) arena_alloc(expansion->memory, sizeof(pathname_directory)); // allocate memory for directory from the arena
+    directory->path = (char *) arena_alloc(expansion->memory, (size_t) ((length + 1 /* for null character */) * sizeof(char))); // allocate memory for the path from the arena
+    memcpy(directory->path, expansion->path, length);
+    directory->path[length] = '\0';
+    directory->names = NULL;
+    directory->num_names = 0;
+    directory->next = expansion->directories;
+    expansion->directories = directory;
+
+#ifdef DEBUG
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Reading directory '%s' to expand a pathname pattern.";
+        const char * shown = length ? directory->path : "."; // the directory being read
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(shown) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, shown);
+        debug_message(dbg_msg);
+    }
+
+#endif // #ifdef DEBUG
+    if (!(dir = opendir(length ? directory->path : "."))) {
+        return directory;
+    }
+
+    while ((entry = readdir(dir))) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) {
+            continue;
+        }
+
+        // Memory allocation
+        if (directory->num_names == capacity) {
+            char ** names = directory->names; // the entries read so far
+
+            capacity = capacity ? 2 * capacity : PATHNAME_MATCHES;
+            directory->names = (char **) arena_alloc(expansion->memory, (size_t) (capacity * sizeof(char *))); // allocate memory for names from the arena
+            if (names) {
+                memcpy(directory->names, names, (size_t) (directory->num_names * sizeof(char *)));
+            }
+        }
+        name = (char *) arena_alloc(expansion->memory, (size_t) ((1 /* for type */ + strlen(entry->d_name) + 1 /* for null character */) * sizeof(char))); // allocate memory for the name from the arena
+        *name = (char) entry->d_type;
+        strcpy(name + 1, entry->d_name);
+        directory->names[directory->num_names++] = name + 1;
+    }
+    closedir(dir);
+
+    qsort(directory->names, (size_t) directory->num_names, sizeof(char *), pathname_compare);
+
+    return directory;
+}
+
+/*
+ * Check whether a directory entry may be a directory, from the type reported
+ * by readdir (which may be unknown on some file systems).
+ *
+ * PARAMETERS
+ *     type: The type of the entry (d_type).
+ *
+ * RETURN VALUE
+ * FALSE if the entry is known not to be a directory, otherwise TRUE.
+ */
+boolean is_directory_type(const unsigned char type) {
+    return (type == DT_DIR) || (type == DT_LNK) || (type == DT_UNKNOWN);
+}
+
+/*
+ * Add a copy of a pathname to the expanded arguments. The copy is marked as
+ * quoted, so that a file name such as "|" does not become an operator.
+ *
+ * PARAMETERS
+ *     expansion: The state of the expansion.
+ *     pathname: The pathname.
+ *     length: The length of the pathname.
+ */
+void pathname_add(pathname_expansion * expansion, const char * pathname, const size_t length) {
+    char * flags; // the flags of the argument
+
+    // Memory allocation
+    flags = (char *) arena_alloc(expansion->memory, (size_t) ((1 /* for flags */ + length + 1 /* for null character */) * sizeof(char))); // allocate memory for the argument from the arena
+    *flags = TOKEN_QUOTED;
+    memcpy(flags + 1, pathname, length);
+    flags[length + 1] = '\0';
+
+    pathname_append(expansion, flags + 1);
+}
+
+/*
+ * Append an argument to the expanded arguments, allocating more space if
+ * necessary.
+ *
+ * PARAMETERS
+ *     expansion: The state of the expansion.
+ *     arg: The argument (or null to terminate the expanded arguments).
+ */
+void pathname_append(pathname_expansion * expansion, char * arg) {
+    if (expansion->num_args == expansion->capacity) {
+        char ** args = expansion->args; // the expanded arguments so far
+
+        // Memory allocation
+        expansion->capacity *= 2;
+        expansion->args = (char **) arena_alloc(expansion->memory, (size_t) (expansion->capacity * sizeof(char *))); // allocate memory for the expanded arguments from the arena
+        memcpy(expansion->args, args, (size_t) (expansion->num_args * sizeof(char *)));
+    }
+
+    expansion->args[expansion->num_args++] = arg;
+}
+
+/*
+ * Check whether part of a pattern contains wildcards.
+ *
+ * PARAMETERS
+ *     pattern: The start of the part of the pattern.
+ *     end: The end of the part of the pattern.
+ *
+ * RETURN VALUE
+ * TRUE if the part of the pattern contains a character of GLOB_CHARACTERS
+ * which is not preceded by GLOB_ESCAPE, otherwise FALSE.
+ */
+boolean has_wildcards(const char * pattern, const char * end) {
+    for (; pattern < end; pattern++) {
+        if (*pattern == GLOB_ESCAPE) {
+            pattern++;
+        } else if (strchr(GLOB_CHARACTERS, *pattern)) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Check whether a name matches part of a pattern. GLOB_ANY_STRING matches any
+ * string (including an empty string), GLOB_ANY_CHARACTER matches any single
+ * character and GLOB_SET_OPEN starts a bracket expression (see bracket_match).
+ * Any other character (or a character preceded by GLOB_ESCAPE) only matches
+ * itself.
+ *
+ * The name is matched in a single pass. When a character does not match, the
+ * match resumes after the most recent GLOB_ANY_STRING, which then matches one
+ * more character of the name. Earlier GLOB_ANY_STRING characters never need to
+ * be revisited, so the time taken is at most proportional to the product of
+ * the lengths of the name and the pattern.
+ *
+ * PARAMETERS
+ *     pattern: The start of the part of the pattern.
+ *     end: The end of the part of the pattern.
+ *     name: The null-terminated name to match.
+ *
+ * RETURN VALUE
+ * TRUE if the name matches, otherwise FALSE.
+ */
+boolean wildcard_match(const char * pattern, const char * end, const char * name) {
+    const char * star_pattern = NULL; // the pattern following the most recent GLOB_ANY_STRING
+    const char * star_name = NULL; // the name matched from that point
+    const char * next; // the pattern following the current character
+    int matched; // does the current character match?
+
+    while (*name) {
+        if ((pattern < end) && (*pattern == GLOB_ANY_STRING)) {
+            star_pattern = ++pattern;
+            star_name = name;
+            continue;
+        }
+
+        if (pattern < end) {
+            next = pattern + 1;
+            if ((*pattern == GLOB_ESCAPE) && (next < end)) {
+                matched = (*next++ == *name);
+            } else if (*pattern == GLOB_ANY_CHARACTER) {
+                matched = TRUE;
+            } else if ((*pattern != GLOB_SET_OPEN) || ((matched = bracket_match(pattern, end, *name, &next)) < 0)) {
+                matched = (*pattern == *name); // not a valid bracket expression, so GLOB_SET_OPEN is an ordinary character
+            }
+
+            if (matched) {
+                pattern = next;
+                name++;
+                continue;
+            }
+        }
+
+        // Let the most recent GLOB_ANY_STRING match one more character
+        if (!star_pattern) {
+            return FALSE;
+        }
+        pattern = star_pattern;
+        name = ++star_name;
+    }
+
+    while ((pattern < end) && (*pattern == GLOB_ANY_STRING)) {
+        pattern++;
+    }
+
+    return pattern == end;
+}
+
+/*
+ * Check whether a character matches a bracket expression of a pattern. A
+ * bracket expression is a set of characters between GLOB_SET_OPEN and
+ * GLOB_SET_CLOSE, which may include ranges (such as "a-z"). If the set starts
+ * with GLOB_SET_NEGATE, it matches any character which is not in the set.
+ * GLOB_SET_CLOSE is part of the set if it is the first character of the set.
+ * A character preceded by GLOB_ESCAPE is an ordinary member of the set.
+ *
+ * PARAMETERS
+ *     pattern: The GLOB_SET_OPEN character which starts the bracket expression.
+ *     end: The end of the part of the pattern.
+ *     c: The character to match.
+ *     next: Set to the pattern following the bracket expression.
+ *
+ * RETURN VALUE
+ * 1 if the character matches, 0 if it does not match, or -1 if the bracket
+ * expression has no GLOB_SET_CLOSE.
+ */
+int bracket_match(const char * pattern, const char * end, const char c, const char ** next) {
+    const char * p = pattern + 1; // the current character of the bracket expression
+    boolean negate = FALSE; // is the set negated?
+    boolean matched = FALSE; // is the character in the set?
+
+    if ((p < end) && (*p == GLOB_SET_NEGATE)) {
+        negate = TRUE;
+        p++;
+    }
+
+    do {
+        if (p >= end) {
+            return -1;
+        }
+
+        if ((*p == GLOB_ESCAPE) && (p + 1 < end)) {
+            // An escaped character
+            if (p[1] == c) {
+                matched = TRUE;
+            }
+            p += 2;
+        } else if ((p + 2 < end) && (p[1] == GLOB_SET_RANGE) && (p[2] != GLOB_SET_CLOSE)) {
+            // A range of characters
+            if (((unsigned char) c >= (unsigned char) p[0]) && ((unsigned char) c <= (unsigned char) p[2])) {
+                matched = TRUE;
+            }
+            p += 3;
+        } else {
+            if (*p == c) {
+                matched = TRUE;
+            }
+            p++;
+        }
+    } while ((p >= end) || (*p != GLOB_SET_CLOSE));
+
+    *next = p + 1;
+    return matched != negate;
+}
+
+/*
+ * Compare two strings, for sorting an array of strings with qsort.
+ *
+ * PARAMETERS
+ *     a: A pointer to the first string.
+ *     b: A pointer to the second string.
+ *
+ * RETURN VALUE
+ * A negative number, 0 or a positive number if the first string is less than,
+ * equal to or greater than the second string.
+ */
+int pathname_compare(const void * a, const void * b) {
+    return strcmp(*(char * const *) a, *(char * const *) b);
+}
@@ -0,0 +1,345 @@
+/*
+ * reader.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the functions used to read command lines and split them
+ * into arguments, including the batch reader.
+ *
+ * When the shell is not reading commands from a terminal, the batch reader
+ * reads and tokenizes command lines in a separate thread, so that reading
+ * (possibly from slow storage) overlaps with the execution of earlier command
+ * lines. The command lines are passed to the shell through a ring of
+ * READER_RING_SIZE entries, each with an arena of its own. The reader thread
+ * is the only producer and the shell is the only consumer, so each index of
+ * the ring is only modified by one thread. The two semaphores count the
+ * entries which are filled and available, and only make a system call when a
+ * thread actually has to wait.
+ */
+
+#include "../inc/reader.h"
+
+/*
+ * This function gets input from the user. If the input is mapped into memory,
+ * the line is returned without being copied. Otherwise, the line is copied to
+ * memory allocated from an arena. Either way, the line remains valid until the
+ * arena is reset.
+ *
+ * PARAMETERS
+ *     input: The input from which the line should be read.
+ *     a: The arena from which to allocate the line (if it must be copied).
+ *     length: Set to the length of the line.
+ *
+ * RETURN VALUE
+ * A pointer to the line, which is NOT necessarily null-terminated, or null if
+ * the end of the input was reached before anything was read.
+ */
+const char * get_input(input_source * input, arena * a, size_t * length) {
+    const char * line; // the line in the input
+    char * input_buffer; // copy of the line
+
+    if (!(line = input_next_line(input, length)) || input->mapped) {
+        return line;
+    }
+
+    // Memory allocation
+    input_buffer = (char *) arena_alloc(a, (size_t) ((*length + 1 /* for null character */) * sizeof(char))); // allocate memory for input_buffer from the arena
+
+    memcpy(input_buffer, line, *length);
+    input_buffer[*length] = '\0';
+    return input_buffer;
+}
+
+/*
+ * Split a command line into an array of arguments. The arguments are allocated
+ * from an arena.
+ *
+ * PARAMETERS
+ *     a: The arena from which to allocate the arguments.
+ *     input_buffer: The command line (which need not be null-terminated).
+ *     length: The length of the command line.
+ *
+ * RETURN VALUE
+ * A pointer to an array of character strings, terminated by a null entry.
+ */
+char ** tokenize_line(arena * a, const char * input_buffer, const size_t length) {
+    lexer lex; // lexer used to split the line into arguments
+    char ** args; // pointers to argument strings
+    char ** arg; // working pointer through arguments
+
+    lexer_init(&lex, input_buffer, length, (char *) arena_alloc(a, lexer_buffer_size(length))); // allocate memory for the tokens from the arena
+
+    // Every argument uses at least one character of the line (an operator may be an argument of a single character), so there are at most length arguments
+    args = (char **) arena_alloc(a, (size_t) ((length + 1 /* for null element */) * sizeof(char *))); // allocate memory for args from the arena
+    arg = args;
+    while ((*arg++ = lexer_next(&lex)));
+
+    return args;
+}
+
+/*
+ * Read the here-documents of a command line. HERE_DOCUMENT_OPERATOR followed by
+ * a delimiter (either in the same argument or in the next) is replaced by a
+ * single argument, marked with TOKEN_HEREDOC, which holds the lines of input
+ * following the command line up to the delimiter (see read_here_document). If
+ * the command line has several here-documents, their lines follow the command
+ * line in the same order.
+ *
+ * PARAMETERS
+ *     input: The input from which the command line was read.
+ *     a: The arena from which the arguments were allocated.
+ *     args: The arguments of the command line. MUST be terminated by a null
+ *         entry.
+ */
+void read_here_documents(input_source * input, arena * a, char ** args) {
+    const size_t operator_length = strlen(HERE_DOCUMENT_OPERATOR); // length of HERE_DOCUMENT_OPERATOR
+
+    for (char ** arg = args; *arg; arg++) {
+        if (!is_unquoted(*arg) || strncmp(*arg, HERE_DOCUMENT_OPERATOR, operator_length) || !strncmp(*arg, HERE_STRING_OPERATOR, strlen(HERE_STRING_OPERATOR))) {
+            continue;
+        }
+
+        if ((*arg)[operator_length]) {
+            // The delimiter is part of the same argument
+            *arg = read_here_document(input, a, *arg + operator_length, FALSE);
+        } else if (arg[1]) {
+            // The delimiter is the next argument, which replaces the operator
+            *(array_movetoend(arg)) = NULL;
+            *arg = read_here_document(input, a, *arg, !is_unquoted(*arg));
+        } // otherwise the missing delimiter is reported when the command is executed
+    }
+}
+
+/*
+ * Read the lines of a here-document, up to (but not including) a line which
+ * consists only of the delimiter, or up to the end of the input. Lines are
+ * always copied, because a line of input which is not mapped into memory is
+ * only valid until the next line is read.
+ *
+ * The here-document is marked with TOKEN_HEREDOC and TOKEN_QUOTED, and with
+ * TOKEN_EXPAND if it contains EXPANSION_CHARACTER and the delimiter was not
+ * quoted, so that its variables and command substitutions are expanded when
+ * the command is executed.
+ *
+ * PARAMETERS
+ *     input: The input from which the lines should be read.
+ *     a: The arena from which to allocate the here-document.
+ *     delimiter: The delimiter.
+ *     quoted: Was the delimiter quoted?
+ *
+ * RETURN VALUE
+ * A pointer to the null-terminated here-document, which is preceded by its
+ * flags (in the same way as an argument returned by lexer_next).
+ */
+char * read_here_document(input_source * input, arena * a, const char * delimiter, const boolean quoted) {
+    const size_t delimiter_length = strlen(delimiter); // length of the delimiter
+    size_t capacity = HERE_DOCUMENT_SIZE; // number of bytes allocated for buffer
+    size_t used = 1; // number of bytes of buffer which are used (including the flags)
+    char * buffer; // the flags and the here-document
+    char * larger; // a larger buffer
+    const char * line; // the current line
+    size_t length; // length of the current line
+    size_t content; // length of the current line without its new-line character
+
+    // Memory allocation
+    buffer = (char *) arena_alloc(a, capacity); // allocate memory for buffer from the arena
+
+    while ((line = input_next_line(input, &length))) {
+        content = (length && (line[length - 1] == '\n')) ? length - 1 : length;
+        if ((content == delimiter_length) && !memcmp(line, delimiter, content)) {
+            break;
+        }
+
+        if (used + length + 1 /* for null character */ > capacity) {
+            while (used + length + 1 /* for null character */ > capacity) {
+                capacity *= 2;
+            }
+
+            // Memory allocation
+            larger = (char *) arena_alloc(a, capacity); // allocate memory for the larger buffer from the arena
+
+            memcpy(larger, buffer, used);
+            buffer = larger;
+        }
+
+        memcpy(buffer + used, line, length);
+        used += length;
+    }
+    buffer[used] = '\0';
+
+    *buffer = TOKEN_HEREDOC | TOKEN_QUOTED;
+    if (!quoted && strchr(buffer + 1, EXPANSION_CHARACTER)) {
+        *buffer |= TOKEN_EXPAND;
+    }
+
+    return buffer + 1;
+}
+
+/*
+ * Start reading command lines from a file in a separate thread. All signals
+ * are blocked in the thread, so that they are handled by the shell.
+ *
+ * PARAMETERS
+ *     r: The batch reader.
+ *     input: The input from which command lines should be read.
+ */
+void reader_start(reader * r, input_source * input) {
+    sigset_t mask; // all signals
+    sigset_t old_mask; // the signal mask to restore
+    int error; // error number returned by pthread_create
+
+    r->input = input;
+    r->head = 0;
+    r->tail = 0;
+    r->holding = FALSE;
+    r->finished = FALSE;
+    r->stopping = FALSE;
+    r->spin = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? READER_SPIN : 0; // spinning is useless if the other thread cannot run at the same time
+    for (unsigned int i = 0; i < READER_RING_SIZE; ++i) {
+        arena_init(&r->commands[i].memory);
+        r->commands[i].line = NULL;
+        r->commands[i].args = NULL;
+        r->commands[i].last = FALSE;
+    }
+
+    if (sem_init(&r->filled, 0, 0) || sem_init(&r->available, 0, READER_RING_SIZE)) sys_err("sem_init"); // attempt to create the semaphores
+
+    // The thread inherits the signal mask
+    sigfillset(&mask);
+    pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+    if ((error = pthread_create(&r->thread, NULL, reader_thread, r))) {
+        errno = error;
+        sys_err("pthread_create");
+    }
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    r->running = TRUE;
+}
+
+/*
+ * Get the next command line read by the batch reader, waiting for it to be read
+ * if necessary. The previous command line returned is released, and so must no
+ * longer be used.
+ *
+ * PARAMETERS
+ *     r: The batch reader.
+ *
+ * RETURN VALUE
+ * The next command line, or null at the end of the input.
+ */
+reader_command * reader_next(reader * r) {
+    reader_command * command; // the next command line
+
+    if (r->finished) {
+        return NULL;
+    }
+
+    // Release the previous command line
+    if (r->holding) {
+        r->tail++;
+        sem_post(&r->available);
+        r->holding = FALSE;
+    }
+
+    reader_wait(&r->filled, r->spin);
+
+    command = &r->commands[r->tail % READER_RING_SIZE];
+    if (!command->line) {
+        r->finished = TRUE;
+        return NULL;
+    }
+
+    r->holding = TRUE;
+    return command;
+}
+
+/*
+ * Wait for a semaphore of the batch reader. The other thread usually posts the
+ * semaphore very soon (it only has to read or execute a single command line),
+ * so the semaphore is checked a number of times before the thread sleeps, to
+ * avoid a context switch for every command line.
+ *
+ * PARAMETERS
+ *     semaphore: The semaphore to wait for.
+ *     spin: The number of times to check the semaphore before sleeping.
+ */
+void reader_wait(sem_t * semaphore, const unsigned int spin) {
+    for (unsigned int i = 0; i < spin; ++i) {
+        if (!sem_trywait(semaphore)) {
+            return;
+        }
+    }
+
+    while (sem_wait(semaphore) && (errno == EINTR)); // sem_wait is interrupted by SIGCHLD even with SA_RESTART
+}
+
+/*
+ * Stop the batch reader and release its memory. The reader thread may be
+ * waiting for input which never arrives (for example, from a pipe), so it is
+ * cancelled rather than waited for.
+ *
+ * PARAMETERS
+ *     r: The batch reader.
+ */
+void reader_stop(reader * r) {
+    if (!r->running) {
+        return;
+    }
+
+    r->stopping = TRUE;
+    sem_post(&r->available); // wake the thread if it is waiting for an entry
+    pthread_cancel(r->thread);
+    pthread_join(r->thread, NULL);
+
+    for (unsigned int i = 0; i < READER_RING_SIZE; ++i) {
+        arena_free(&r->commands[i].memory);
+    }
+    sem_destroy(&r->filled);
+    sem_destroy(&r->available);
+    r->running = FALSE;
+}
+
+/*
+ * Read and tokenize command lines until the end of the input, storing each in
+ * the next available entry of the ring. This is the thread function of the
+ * batch reader. The thread can only be cancelled while it is reading input, so
+ * that it is never cancelled while modifying the ring.
+ *
+ * PARAMETERS
+ *     data: The batch reader.
+ *
+ * RETURN VALUE
+ * Always null.
+ */
+void * reader_thread(void * data) {
+    reader * r = (reader *) data; // the batch reader
+    reader_command * command; // the entry being filled
+
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+    do {
+        // Wait for an entry to become available
+        reader_wait(&r->available, r->spin);
+        if (r->stopping) {
+            break;
+        }
+
+        command = &r->commands[r->head % READER_RING_SIZE];
+        arena_reset(&command->memory);
+
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+        command->line = get_input(r->input, &command->memory, &command->length);
+        command->args = command->line ? tokenize_line(&command->memory, command->line, command->length) : NULL;
+        if (command->args) {
+            read_here_documents(r->input, &command->memory, command->args);
+        }
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+
+        command->last = input_at_end(r->input);
+        r->head++;
+        sem_post(&r->filled);
+    } while (command->line);
+
+    return NULL;
+}
@@ -0,0 +1,511 @@
+/*
+ * redirect.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the redirection of the file descriptors of a command.
+ *
+ * The redirections of a command are collected in a table, in the order in
+ * which they appear, as pairs of a file descriptor of the command and the file
+ * descriptor of the shell which it becomes a copy of. A redirection to another
+ * file descriptor of the command (such as "2>&1") is resolved against the
+ * redirections before it when the table is built, so the table can be applied
+ * in order by dup2 alone: by posix_spawn file actions (see launch_program), in
+ * a child process, or to the shell itself around an internal command.
+ *
+ * Files are opened with O_CLOEXEC and moved to file descriptors of at least
+ * REDIRECT_SHELL_FD, so that they are never inherited by a command except
+ * through a redirection, and are never overwritten while the redirections are
+ * applied.
+ */
+
+#include "../inc/redirect.h"
+
+redirection_table redirects; // the redirections of the command being executed
+
+/*
+ * Remove the redirections from the arguments of a command, and open the files
+ * (and create the here-documents) which they refer to. If any redirection
+ * fails, an error message is displayed and the command should not be
+ * executed. The files which have been opened must be closed with
+ * redirect_close either way.
+ *
+ * PARAMETERS
+ *     table: The table to which the redirections are added.
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * TRUE if every redirection succeeded, otherwise FALSE.
+ */
+boolean redirect_parse(redirection_table * table, char ** args) {
+    char ** arg = args; // working pointer through arguments
+    const char * operator_arg; // the argument containing the redirection operator
+    const char * target; // the file (or file descriptor) to which the redirection refers
+    int op; // the redirection operator
+    int fd; // the file descriptor of the command which is redirected
+    int source; // the file descriptor of the shell which it becomes a copy of
+
+    while (*arg) {
+        if (!(op = redirect_operator(*arg, &fd, &target))) {
+            arg++;
+            continue;
+        }
+        operator_arg = *arg;
+
+        if (op == REDIRECT_NO_DELIMITER) {
+            error_redirect(operator_arg, "No delimiter was specified for the here-document");
+            return FALSE;
+        }
+
+        // The target may be the next argument
+        if (!*target && (op != REDIRECT_HERE_DOCUMENT)) {
+            if (!*(arg + 1)) {
+                error_redirect(operator_arg, "No file was specified");
+                return FALSE;
+            }
+            target = *(arg + 1);
+            *(array_movetoend(arg + 1)) = NULL; // move the target to end of argument array and set to null
+        }
+
+        if (fd > REDIRECT_MAX_FD) {
+            error_redirect(operator_arg, strerror(EBADF));
+            return FALSE;
+        }
+
+        switch (op) {
+            case REDIRECT_INPUT:
+                source = redirect_open(table, target, O_RDONLY);
+                break;
+
+            case REDIRECT_OUTPUT:
+            case REDIRECT_BOTH:
+                source = redirect_open(table, target, O_WRONLY | O_CREAT | O_TRUNC);
+                break;
+
+            case REDIRECT_APPEND:
+            case REDIRECT_BOTH_APPEND:
+                source = redirect_open(table, target, O_WRONLY | O_CREAT | O_APPEND);
+                break;
+
+            case REDIRECT_HERE_STRING:
+                source = redirect_here_document(table, target, TRUE);
+                break;
+
+            case REDIRECT_HERE_DOCUMENT:
+                source = redirect_here_document(table, target, FALSE);
+                break;
+
+            default: // REDIRECT_DUPLICATE
+                if ((target[0] == REDIRECTION_CLOSE_CHAR) && !target[1]) {
+                    source = -1;
+                } else if (isdigit((unsigned char) target[0]) && !target[1] && (target[0] - '0' <= REDIRECT_MAX_FD)) {
+                    source = redirect_target(table, target[0] - '0');
+                } else {
+                    error_redirect(operator_arg, strerror(EBADF));
+                    return FALSE;
+                }
+                if (!redirect_add(table, fd, source, target)) {
+                    return FALSE;
+                }
+                *(array_movetoend(arg)) = NULL; // move the redirection operator to end of argument array and set to null
+                continue;
+        }
+
+        if (source < 0) {
+            error_redirect((op == REDIRECT_HERE_DOCUMENT) ? HERE_DOCUMENT_OPERATOR : target, strerror(errno));
+            return FALSE;
+        }
+
+        // Redirect stdout as well as stderr
+        if (((op == REDIRECT_BOTH) || (op == REDIRECT_BOTH_APPEND)) && !redirect_add(table, STDOUT_FILENO, source, target)) {
+            return FALSE;
+        }
+
+        if (!redirect_add(table, fd, source, (op == REDIRECT_HERE_DOCUMENT) ? HERE_DOCUMENT_OPERATOR : target)) {
+            return FALSE;
+        }
+        *(array_movetoend(arg)) = NULL; // move the redirection operator to end of argument array and set to null
+    }
+
+    return TRUE;
+}
+
+/*
+ * Recognise a redirection operator. A redirection operator is an argument
+ * without quotation marks which consists of an optional file descriptor, the
+ * operator and an optional target (otherwise the target is the next argument).
+ * A here-document (see read_here_documents) is also a redirection.
+ *
+ * PARAMETERS
+ *     arg: An argument returned by lexer_next.
+ *     fd: Set to the file descriptor of the command which is redirected.
+ *     target: Set to the target in the same argument (an empty string if the
+ *         target is the next argument).
+ *
+ * RETURN VALUE
+ * The redirection operator, or REDIRECT_NONE if the argument is not a
+ * redirection.
+ */
+int redirect_operator(const char * arg, int * fd, const char ** target) {
+    const char * p = arg; // the current character
+    int n = -1; // the file descriptor before the operator (-1 if none)
+
+    if (arg[-1] & TOKEN_HEREDOC) {
+        *fd = STDIN_FILENO;
+        *target = arg;
+        return REDIRECT_HERE_DOCUMENT;
+    }
+
+    if (!is_unquoted(arg)) {
+        return REDIRECT_NONE;
+    }
+
+    // Redirect both stdout and stderr
+    if ((p[0] == REDIRECTION_FD_CHAR) && (p[1] == OUTPUT_REDIRECTION_CHAR)) {
+        *fd = STDERR_FILENO;
+        if (p[2] == OUTPUT_REDIRECTION_CHAR) {
+            *target = p + 3;
+            return REDIRECT_BOTH_APPEND;
+        }
+        *target = p + 2;
+        return REDIRECT_BOTH;
+    }
+
+    if (!strcmp(arg, HERE_DOCUMENT_OPERATOR)) {
+        return REDIRECT_NO_DELIMITER;
+    }
+    if (!strncmp(arg, HERE_STRING_OPERATOR, strlen(HERE_STRING_OPERATOR))) {
+        *fd = STDIN_FILENO;
+        *target = arg + strlen(HERE_STRING_OPERATOR);
+        return REDIRECT_HERE_STRING;
+    }
+
+    // Read the file descriptor
+    if (isdigit((unsigned char) *p)) {
+        for (n = 0; isdigit((unsigned char) *p); p++) {
+            if (n <= REDIRECT_MAX_FD) {
+                n = (n * 10) + (*p - '0');
+            }
+        }
+    }
+
+    if (*p == INPUT_REDIRECTION_CHAR) {
+        *fd = (n < 0) ? STDIN_FILENO : n;
+        if (p[1] == REDIRECTION_FD_CHAR) {
+            *target = p + 2;
+            return REDIRECT_DUPLICATE;
+        }
+        if (p[1] == INPUT_REDIRECTION_CHAR) {
+            return REDIRECT_NONE;
+        }
+        *target = p + 1;
+        return REDIRECT_INPUT;
+    }
+
+    if (*p == OUTPUT_REDIRECTION_CHAR) {
+        *fd = (n < 0) ? STDOUT_FILENO : n;
+        if (p[1] == REDIRECTION_FD_CHAR) {
+            *target = p + 2;
+            return REDIRECT_DUPLICATE;
+        }
+        if (p[1] == OUTPUT_REDIRECTION_CHAR) {
+            *target = p + 2;
+            return REDIRECT_APPEND;
+        }
+        *target = p + 1;
+        return REDIRECT_OUTPUT;
+    }
+
+    return REDIRECT_NONE;
+}
+
+/*
+ * Add a redirection to a table.
+ *
+ * PARAMETERS
+ *     table: The table.
+ *     fd: The file descriptor of the command which is redirected.
+ *     source: The file descriptor of the shell which it becomes a copy of (-1
+ *         if it is closed).
+ *     target: The target of the redirection (for messages).
+ *
+ * RETURN VALUE
+ * TRUE if the redirection was added, or FALSE if the table is full.
+ */
+boolean redirect_add(redirection_table * table, const int fd, const int source, const char * target) {
+    if (table->num_entries == REDIRECT_MAX) {
+        error_redirect(target, "Too many redirections");
+        return FALSE;
+    }
+
+    table->entries[table->num_entries].fd = fd;
+    table->entries[table->num_entries].source = source;
+    table->num_entries++;
+#ifdef DEBUG
+
+    if (debug) {
+        // Create debug message
+        const char msg[] = "File descriptor %d will be redirected to '%s' (file descriptor %d).";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + digits(fd) + strlen(target) + digits(source) + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, fd, target, source);
+        debug_message(dbg_msg);
+    }
+#endif // #ifdef DEBUG
+
+    return TRUE;
+}
+
+/*
+ * Open a file for a redirection (see redirect_keep).
+ *
+ * PARAMETERS
+ *     table: The table which the file belongs to.
+ *     file: The path of the file.
+ *     flags: The flags with which the file should be opened.
+ *
+ * RETURN VALUE
+ * The file descriptor of the file on success. On failure, -1 is returned and
+ * errno is set to indicate the error.
+ */
+int redirect_open(redirection_table * table, const char * file, const int flags) {
+    const int fd = open(file, flags | O_CLOEXEC, 0666); // the file
+
+    return (fd < 0) ? -1 : redirect_keep(table, fd);
+}
+
+/*
+ * Create a file holding a here-document or here-string, from which a command
+ * can read its input. The file exists only in memory (see memfd_create), so
+ * nothing is written to the file system and nothing has to be removed
+ * afterwards. The file is sealed once it has been written, so that it cannot
+ * be changed while the command reads it.
+ *
+ * PARAMETERS
+ *     table: The table which the file belongs to.
+ *     content: A null-terminated string containing the here-document or
+ *         here-string.
+ *     newline: Should a new-line character be added after the content (as it
+ *         is for a here-string)?
+ *
+ * RETURN VALUE
+ * The file descriptor of the file, open for reading from its start.
+ */
+int redirect_here_document(redirection_table * table, const char * content, const boolean newline) {
+    const char new_line[] = "\n"; // added after a here-string
+    int fd; // the file
+
+    if ((fd = memfd_create(HERE_DOCUMENT_NAME, MFD_CLOEXEC | MFD_ALLOW_SEALING)) < 0) sys_err("memfd_create"); // attempt to create the file
+    if (write_all(fd, content, strlen(content)) || (newline && write_all(fd, new_line, strlen(new_line)))) sys_err("write"); // attempt to write the content to the file
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL)) sys_err("fcntl"); // attempt to seal the file
+    if (lseek(fd, (off_t) 0, SEEK_SET)) sys_err("lseek"); // attempt to return to the start of the file
+
+    return redirect_keep(table, fd);
+}
+
+/*
+ * Move a file descriptor opened for a redirection to at least
+ * REDIRECT_SHELL_FD (keeping it close-on-exec), so that it is not overwritten
+ * while the redirections are applied, and remember it so that it is closed by
+ * redirect_close.
+ *
+ * PARAMETERS
+ *     table: The table which the file belongs to.
+ *     fd: The file descriptor, which must be close-on-exec.
+ *
+ * RETURN VALUE
+ * The new file descriptor on success. On failure, -1 is returned and errno is
+ * set to indicate the error.
+ */
+int redirect_keep(redirection_table * table, const int fd) {
+    int moved = fd; // the new file descriptor
+
+    if (table->num_opened == REDIRECT_MAX) {
+        close(fd);
+        errno = EMFILE;
+        return -1;
+    }
+
+    if (fd < REDIRECT_SHELL_FD) {
+        moved = fcntl(fd, F_DUPFD_CLOEXEC, REDIRECT_SHELL_FD);
+        close(fd);
+        if (moved < 0) {
+            return -1;
+        }
+    }
+
+    table->opened[table->num_opened++] = moved;
+    return moved;
+}
+
+/*
+ * Find the file descriptor of the shell which a file descriptor of the command
+ * refers to, once every redirection in a table has been applied.
+ *
+ * PARAMETERS
+ *     table: The table.
+ *     fd: The file descriptor of the command.
+ *
+ * RETURN VALUE
+ * The file descriptor of the shell, or -1 if the file descriptor is closed.
+ */
+int redirect_target(const redirection_table * table, const int fd) {
+    for (unsigned int i = table->num_entries; i > 0; --i) {
+        if (table->entries[i - 1].fd == fd) {
+            return table->entries[i - 1].source;
+        }
+    }
+
+    return fd;
+}
+
+/*
+ * Check whether a file descriptor of the command is redirected.
+ *
+ * PARAMETERS
+ *     table: The table.
+ *     fd: The file descriptor of the command.
+ *
+ * RETURN VALUE
+ * TRUE if the file descriptor does not refer to the same file as it does in
+ * the shell, otherwise FALSE.
+ */
+boolean is_redirected(const redirection_table * table, const int fd) {
+    return redirect_target(table, fd) != fd;
+}
+
+/*
+ * Remove the redirections of a file descriptor from a table (for a command
+ * which does not support them). The files remain open until redirect_close.
+ *
+ * PARAMETERS
+ *     table: The table.
+ *     fd: The file descriptor of the command.
+ */
+void redirect_forget(redirection_table * table, const int fd) {
+    unsigned int used = 0; // number of entries which are kept
+
+    for (unsigned int i = 0; i < table->num_entries; ++i) {
+        if (table->entries[i].fd != fd) {
+            table->entries[used++] = table->entries[i];
+        }
+    }
+    table->num_entries = used;
+}
+
+/*
+ * Apply the redirections in a table to the file descriptors of the current
+ * process, in order. This is used in a child process before a program is
+ * executed, and by the shell itself around an internal command (in which case
+ * each file descriptor is saved first, so that it can be restored by
+ * redirect_restore).
+ *
+ * PARAMETERS
+ *     table: The table.
+ *     saved: An array of REDIRECT_MAX_FD + 1 entries in which to save the file
+ *         descriptors which are changed, or null if they should not be saved.
+ */
+void redirect_apply(const redirection_table * table, int * saved) {
+    if (saved) {
+        for (int fd = 0; fd <= REDIRECT_MAX_FD; ++fd) {
+            saved[fd] = REDIRECT_NOT_SAVED;
+        }
+    }
+
+    if (!table->num_entries) {
+        return;
+    }
+
+    // Make sure that previous output goes to the original files
+    writer_flush(&shell_output);
+    fflush(stderr);
+
+    for (unsigned int i = 0; i < table->num_entries; ++i) {
+        const redirection * r = &table->entries[i]; // the current redirection
+
+        if (r->source == r->fd) {
+            continue;
+        }
+
+        // Save the file descriptor the first time it is changed (-1 if it was not open)
+        if (saved && (saved[r->fd] == REDIRECT_NOT_SAVED)) {
+            saved[r->fd] = fcntl(r->fd, F_DUPFD_CLOEXEC, REDIRECT_SHELL_FD);
+        }
+
+        if (r->source < 0) {
+            close(r->fd);
+        } else {
+            dup2(r->source, r->fd);
+        }
+    }
+}
+
+/*
+ * Undo the redirections applied to the file descriptors of the shell by
+ * redirect_apply.
+ *
+ * PARAMETERS
+ *     table: The table which was applied.
+ *     saved: The file descriptors saved by redirect_apply.
+ */
+void redirect_restore(const redirection_table * table, const int * saved) {
+    if (!table->num_entries) {
+        return;
+    }
+
+    // Make sure that output goes to the redirected files
+    writer_flush(&shell_output);
+    fflush(stderr);
+
+    for (int fd = 0; fd <= REDIRECT_MAX_FD; ++fd) {
+        if (saved[fd] >= 0) {
+            dup2(saved[fd], fd);
+            close(saved[fd]);
+        } else if (saved[fd] != REDIRECT_NOT_SAVED) {
+            close(fd);
+        }
+    }
+}
+
+/*
+ * Close the files opened for the redirections in a table, and empty the table.
+ * Any child process which needs the files has its own copy by now.
+ *
+ * PARAMETERS
+ *     table: The table.
+ */
+void redirect_close(redirection_table * table) {
+    for (unsigned int i = 0; i < table->num_opened; ++i) {
+        close(table->opened[i]);
+    }
+    table->num_opened = 0;
+    table->num_entries = 0;
+}
+
+/*
+ * Display an error message that a redirection failed, and record the failure
+ * as the status of the command.
+ *
+ * PARAMETERS
+ *     target: The target of the redirection.
+ *     reason: The reason for the failure.
+ */
+void error_redirect(const char * target, const char * reason) {
+    // Create error message
+    const char msg[] = "Unable to redirect '%s': %s.";
+    char * err_msg;
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(target) + strlen(reason) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, target, reason);
+    err(err_msg);
+    proc_info.status = JOB_FAILURE_STATUS;
+}
@@ -0,0 +1,702 @@
+/*
+ * server.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the shell server and its client. A shell which is started
+ * with SERVE_OPTION listens on a Unix domain socket and, for each client which
+ * connects, forks a session which executes the command lines of the client
+ * exactly as a newly started shell would, but without the cost of starting one
+ * (loading the executable, importing the environment, building the internal
+ * command index, and so on). A single epoll loop accepts any number of clients
+ * at once.
+ *
+ * A shell which is started with CLIENT_OPTION sends its arguments, its
+ * environment, its current working directory and its stdin, stdout and stderr
+ * (as file descriptors, with SCM_RIGHTS) to the server, and then waits for the
+ * exit status of the session. The session writes directly to the stdout and
+ * stderr of the client, so output is never copied through the server. If no
+ * server is listening, the client executes the command lines itself.
+ */
+
+#include "../inc/server.h"
+
+server_client * server_clients = NULL; // the clients of the server
+int server_listen_fd = -1; // the socket on which the server listens
+int server_signal_fd = -1; // the signals received by the server
+int server_epoll_fd = -1; // the activity which the server is waiting for
+sigset_t server_saved_mask; // the signal mask of the shell before the server started
+volatile sig_atomic_t client_signal = 0; // a signal received by the client which has not yet been passed to the server
+
+/*
+ * Run the shell server, which executes the command lines of its clients until
+ * it receives SIGTERM, SIGINT or SIGHUP. Sessions which are still running when
+ * the server stops are not affected.
+ *
+ * PARAMETERS
+ *     socket_path: The path of the socket on which the server should listen.
+ *
+ * RETURN VALUE
+ * EXIT_SUCCESS if the server stopped because of a signal, otherwise
+ * EXIT_FAILURE.
+ */
+int server_run(const char * socket_path) {
+    sigset_t signals; // the signals received through server_signal_fd
+    struct epoll_event event; // an event to wait for
+    struct epoll_event events[SERVER_MAX_EVENTS]; // the events which occurred
+    struct signalfd_siginfo info; // a signal which was received
+    boolean running = TRUE; // should the server keep running?
+    int num_events; // number of events which occurred
+
+    // Receive signals through a file descriptor, so that they can be handled by the epoll loop
+    signal(SIGINT, SIG_DFL); // an ignored signal is never delivered to the signal file descriptor
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGCHLD);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGHUP);
+    if (sigprocmask(SIG_BLOCK, &signals, &server_saved_mask)) sys_err("sigprocmask"); // attempt to block the signals
+    if ((server_signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC)) < 0) sys_err("signalfd"); // attempt to create the signal file descriptor
+
+    if ((server_listen_fd = server_listen(socket_path)) < 0) {
+        close(server_signal_fd);
+        sigprocmask(SIG_SETMASK, &server_saved_mask, NULL);
+        return EXIT_FAILURE;
+    }
+
+    if ((server_epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) sys_err("epoll_create1"); // attempt to create the epoll instance
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = &server_listen_fd;
+    if (epoll_ctl(server_epoll_fd, EPOLL_CTL_ADD, server_listen_fd, &event)) sys_err("epoll_ctl"); // attempt to wait for connections
+    event.data.ptr = &server_signal_fd;
+    if (epoll_ctl(server_epoll_fd, EPOLL_CTL_ADD, server_signal_fd, &event)) sys_err("epoll_ctl"); // attempt to wait for signals
+
+    while (running) {
+        arena_reset(&line_arena); // memory for error messages
+
+        if ((num_events = epoll_wait(server_epoll_fd, events, SERVER_MAX_EVENTS, -1)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            sys_err("epoll_wait");
+        }
+
+        for (int i = 0; i < num_events; ++i) {
+            if (events[i].data.ptr == &server_listen_fd) {
+                server_accept();
+            } else if (events[i].data.ptr == &server_signal_fd) {
+                while (read(server_signal_fd, &info, sizeof(info)) == (ssize_t) sizeof(info)) {
+                    if (info.ssi_signo == SIGCHLD) {
+                        server_reap();
+                    } else {
+                        running = FALSE;
+                    }
+                }
+            } else {
+                server_client_event((server_client *) events[i].data.ptr);
+            }
+        }
+    }
+
+    // Clean up
+    while (server_clients) {
+        server_close_client(server_clients);
+    }
+    close(server_epoll_fd);
+    close(server_listen_fd);
+    close(server_signal_fd);
+    unlink(socket_path);
+    sigprocmask(SIG_SETMASK, &server_saved_mask, NULL);
+    signal(SIGINT, SIG_IGN);
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Create the socket on which the server listens. A socket left behind by a
+ * server which is no longer running is replaced, but a socket on which another
+ * server is listening is not. The socket may only be used by the user who
+ * started the server.
+ *
+ * PARAMETERS
+ *     socket_path: The path of the socket.
+ *
+ * RETURN VALUE
+ * The listening socket, or -1 (after an error message has been displayed) if
+ * the socket could not be created.
+ */
+int server_listen(const char * socket_path) {
+    struct sockaddr_un address; // the address of the socket
+    mode_t mask; // the file mode creation mask of the shell
+    int fd; // the socket
+
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        error_server(socket_path, strerror(ENAMETOOLONG));
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) sys_err("socket"); // attempt to create the socket
+
+    // Replace the socket of a server which is no longer running
+    if (!connect(fd, (struct sockaddr *) &address, sizeof(address))) {
+        error_server(socket_path, "Another server is already listening");
+        close(fd);
+        return -1;
+    }
+    if (errno == ECONNREFUSED) {
+        unlink(socket_path);
+    }
+
+    // Create the socket without permissions for other users, so that it is never usable by them
+    mask = umask(S_IRWXG | S_IRWXO | S_IXUSR);
+    if (bind(fd, (struct sockaddr *) &address, sizeof(address)) || listen(fd, SERVER_BACKLOG)) {
+        error_server(socket_path, strerror(errno));
+        umask(mask);
+        close(fd);
+        return -1;
+    }
+    umask(mask);
+
+    return fd;
+}
+
+/*
+ * Accept the connections waiting on the socket of the server, and wait for the
+ * requests of the new clients.
+ */
+void server_accept(void) {
+    struct epoll_event event; // the event to wait for
+    server_client * client; // the new client
+    int fd; // the connection to the new client
+
+    while ((fd = accept4(server_listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        // Memory allocation
+        if (!(client = (server_client *) calloc((size_t) 1, sizeof(server_client)))) sys_err("calloc"); // attempt to allocate memory for the client
+
+        client->fd = fd;
+        for (unsigned int i = 0; i < SERVER_NUM_FDS; ++i) {
+            client->fds[i] = -1;
+        }
+        client->next = server_clients;
+        server_clients = client;
+
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.ptr = client;
+        if (epoll_ctl(server_epoll_fd, EPOLL_CTL_ADD, fd, &event)) sys_err("epoll_ctl"); // attempt to wait for the request of the client
+    }
+
+    if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) && (errno != ECONNABORTED)) {
+        error_server("accept", strerror(errno)); // most likely out of file descriptors, so try again later
+    }
+}
+
+/*
+ * Handle activity on the connection to a client. Before the session of the
+ * client has started, this is more of the request of the client. Afterwards,
+ * each byte received is a signal (such as SIGINT when Ctrl+C is pressed at the
+ * terminal of the client) which is passed to the processes of the session.
+ *
+ * PARAMETERS
+ *     client: The client.
+ */
+void server_client_event(server_client * client) {
+    unsigned char signals[16]; // signals passed by the client
+    ssize_t bytes; // number of bytes received
+
+    if (!client->pid) {
+        switch (server_receive(client)) {
+            case 1:
+                if (server_request_valid(client)) {
+                    server_start_session(client);
+                } else {
+                    error_server("request", "The request of a client was not understood");
+                    server_close_client(client);
+                }
+                break;
+
+            case -1:
+                server_close_client(client);
+                break;
+        }
+        return;
+    }
+
+    while ((bytes = recv(client->fd, signals, sizeof(signals), 0)) > 0) {
+        for (ssize_t i = 0; i < bytes; ++i) {
+            if ((signals[i] == SIGINT) || (signals[i] == SIGQUIT) || (signals[i] == SIGTERM) || (signals[i] == SIGHUP)) {
+                kill(-client->pid, (int) signals[i]); // the session is the leader of its own process group
+            }
+        }
+    }
+
+    if (!bytes || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))) {
+        // The client has gone, but the session is forgotten only when it has been reaped
+        epoll_ctl(server_epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+        close(client->fd);
+        client->fd = -1;
+    }
+}
+
+/*
+ * Receive as much more of the request of a client as is available without
+ * waiting. The file descriptors of the client arrive with the first byte of the
+ * request.
+ *
+ * PARAMETERS
+ *     client: The client.
+ *
+ * RETURN VALUE
+ * 1 if the request is complete, 0 if more of the request is still to come, or
+ * -1 if the connection to the client should be closed.
+ */
+int server_receive(server_client * client) {
+    union {
+        struct cmsghdr header;
+        char data[CMSG_SPACE(SERVER_NUM_FDS * sizeof(int))];
+    } control; // the file descriptors of the client
+    struct msghdr message; // the message being received
+    struct iovec part; // where the bytes of the message are stored
+    struct cmsghdr * cmsg; // working pointer through the control messages
+    ssize_t bytes; // number of bytes received
+
+    // Receive the header of the request
+    while (client->header_received < sizeof(server_request)) {
+        part.iov_base = (char *) &client->request + client->header_received;
+        part.iov_len = sizeof(server_request) - client->header_received;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &part;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data;
+        message.msg_controllen = sizeof(control.data);
+
+        if ((bytes = recvmsg(client->fd, &message, MSG_CMSG_CLOEXEC)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? 0 : -1;
+        }
+        if (!bytes) {
+            return -1;
+        }
+
+        for (cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS)) {
+                const unsigned int num_fds = (unsigned int) ((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int)); // number of file descriptors received
+                int fds[SERVER_NUM_FDS * 2]; // the file descriptors received
+
+                memcpy(fds, CMSG_DATA(cmsg), (num_fds < SERVER_NUM_FDS * 2 ? num_fds : SERVER_NUM_FDS * 2) * sizeof(int));
+                if ((num_fds == SERVER_NUM_FDS) && (client->fds[0] < 0)) {
+                    memcpy(client->fds, fds, sizeof(client->fds));
+                } else {
+                    for (unsigned int i = 0; (i < num_fds) && (i < SERVER_NUM_FDS * 2); ++i) {
+                        close(fds[i]);
+                    }
+                }
+            }
+        }
+        if (message.msg_flags & MSG_CTRUNC) {
+            return -1;
+        }
+
+        client->header_received += (size_t) bytes;
+        if (client->header_received == sizeof(server_request)) {
+            if ((client->request.magic != SERVER_MAGIC) || !client->request.length || (client->request.length > SERVER_MAX_REQUEST)) {
+                return -1;
+            }
+
+            // Memory allocation
+            if (!(client->strings = (char *) malloc((size_t) client->request.length))) sys_err("malloc"); // attempt to allocate memory for the strings of the request
+        }
+    }
+
+    // Receive the strings of the request
+    while (client->strings_received < client->request.length) {
+        if ((bytes = recv(client->fd, client->strings + client->strings_received, client->request.length - client->strings_received, 0)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? 0 : -1;
+        }
+        if (!bytes) {
+            return -1;
+        }
+        client->strings_received += (size_t) bytes;
+    }
+
+    return 1;
+}
+
+/*
+ * Check whether the complete request of a client is well-formed: the file
+ * descriptors of the client were received, and the strings of the request are
+ * exactly the current working directory, the arguments and the environment
+ * variables.
+ *
+ * PARAMETERS
+ *     client: The client.
+ *
+ * RETURN VALUE
+ * TRUE if the request is well-formed, otherwise FALSE.
+ */
+boolean server_request_valid(const server_client * client) {
+    size_t num_strings = 0; // number of strings in the request
+
+    for (unsigned int i = 0; i < SERVER_NUM_FDS; ++i) {
+        if (client->fds[i] < 0) {
+            return FALSE;
+        }
+    }
+
+    if (client->strings[client->request.length - 1]) {
+        return FALSE; // the last string is not null-terminated
+    }
+    for (size_t i = 0; i < client->request.length; ++i) {
+        if (!client->strings[i]) {
+            num_strings++;
+        }
+    }
+
+    return num_strings == (size_t) 1 /* current working directory */ + client->request.num_args + client->request.num_env;
+}
+
+/*
+ * Start a session to execute the command lines of a client, in a child process
+ * of the server. The server keeps the connection to the client only to pass on
+ * signals, until the session has been reaped.
+ *
+ * PARAMETERS
+ *     client: The client, whose request is complete and well-formed.
+ */
+void server_start_session(server_client * client) {
+    pid_t pid; // the session
+
+    writer_flush(&shell_output); // otherwise the session would write the output of the server again
+    if ((pid = fork()) < 0) {
+        error_server("fork", strerror(errno));
+        server_close_client(client);
+        return;
+    } else if (!pid) {
+        server_session(client);
+    }
+
+    client->pid = pid;
+
+    // The session has its own copies of the file descriptors and strings of the client
+    for (unsigned int i = 0; i < SERVER_NUM_FDS; ++i) {
+        close(client->fds[i]);
+        client->fds[i] = -1;
+    }
+    free(client->strings);
+    client->strings = NULL;
+}
+
+/*
+ * Execute the command lines of a client as a newly started shell would, in the
+ * current working directory and with the environment, stdin, stdout and stderr
+ * of the client, and then send the exit status to the client. The session is a
+ * session of its own (in the sense of setsid), so the shell never takes control
+ * of the terminal of the client, and it is never replaced by the last command
+ * it executes, because it must report the exit status.
+ *
+ * This function is executed in the child process created by
+ * server_start_session, and never returns.
+ *
+ * PARAMETERS
+ *     client: The client.
+ */
+void server_session(server_client * client) {
+    char ** argv; // the arguments of the shell
+    char * string; // working pointer through the strings of the request
+    int32_t status; // the exit status of the session
+
+    // Forget everything which belongs to the server
+    close(server_epoll_fd);
+    close(server_listen_fd);
+    close(server_signal_fd);
+    for (server_client * other = server_clients; other; other = other->next) {
+        if (other != client) {
+            if (other->fd >= 0) {
+                close(other->fd);
+            }
+            for (unsigned int i = 0; i < SERVER_NUM_FDS; ++i) {
+                if (other->fds[i] >= 0) {
+                    close(other->fds[i]);
+                }
+            }
+        }
+    }
+    sigprocmask(SIG_SETMASK, &server_saved_mask, NULL);
+    signal(SIGINT, SIG_IGN);
+    setsid();
+
+    // Use the stdin, stdout and stderr of the client
+    for (int i = 0; i < SERVER_NUM_FDS; ++i) {
+        if (client->fds[i] < SERVER_NUM_FDS) {
+            // Move the file descriptor out of the way of those which are about to be replaced
+            if ((client->fds[i] = fcntl(client->fds[i], F_DUPFD_CLOEXEC, SERVER_NUM_FDS)) < 0) sys_err("fcntl");
+        }
+    }
+    for (int i = 0; i < SERVER_NUM_FDS; ++i) {
+        if (dup2(client->fds[i], i) < 0) sys_err("dup2"); // attempt to replace the file descriptor
+        close(client->fds[i]);
+    }
+
+    // Use the current working directory of the client
+    string = client->strings;
+    if (chdir(string)) {
+        error_server(string, strerror(errno));
+        status = EXIT_FAILURE;
+        send(client->fd, &status, sizeof(status), MSG_NOSIGNAL);
+        _exit(EXIT_FAILURE);
+    }
+    string += strlen(string) + 1;
+
+    // Memory allocation
+    if (!(argv = (char **) malloc((size_t) ((client->request.num_args + 2 /* name of the shell and null entry */) * sizeof(char *))))) sys_err("malloc"); // attempt to allocate memory for argv
+
+    argv[0] = path;
+    for (uint32_t i = 1; i <= client->request.num_args; ++i) {
+        argv[i] = string;
+        string += strlen(string) + 1;
+    }
+    argv[client->request.num_args + 1] = NULL;
+
+    // Use the environment of the client
+    clearenv();
+    for (uint32_t i = 0; i < client->request.num_env; ++i) {
+        if (strchr(string, ASSIGNMENT_CHARACTER)) {
+            putenv(string);
+        }
+        string += strlen(string) + 1;
+    }
+    variables_free();
+    variables_setup();
+    variable_set("shell", strlen("shell"), path, TRUE);
+    child_environment_reset();
+    path_cache_clear(); // PATH may be different
+
+    replace_last = FALSE;
+    status = (int32_t) run_shell((int) client->request.num_args + 1, argv);
+
+    // Report the exit status to the client
+    writer_flush(&shell_output);
+    send(client->fd, &status, sizeof(status), MSG_NOSIGNAL);
+    _exit((int) status);
+}
+
+/*
+ * Reap the sessions which have finished, and forget their clients.
+ */
+void server_reap(void) {
+    server_client * client; // working pointer through the clients
+    pid_t pid; // a session which has finished
+
+    while ((pid = waitpid(-1, NULL, WNOHANG)) > 0) {
+        for (client = server_clients; client && (client->pid != pid); client = client->next);
+        if (client) {
+            server_close_client(client);
+        }
+    }
+}
+
+/*
+ * Close the connection to a client and forget the client. A session which is
+ * running is not affected.
+ *
+ * PARAMETERS
+ *     client: The client.
+ */
+void server_close_client(server_client * client) {
+    server_client ** link; // the pointer to the client in the list of clients
+
+    for (link = &server_clients; *link != client; link = &(*link)->next);
+    *link = client->next;
+
+    if (client->fd >= 0) {
+        epoll_ctl(server_epoll_fd, EPOLL_CTL_DEL, client->fd, NULL); // the session may still have a copy of the connection
+        close(client->fd);
+    }
+    for (unsigned int i = 0; i < SERVER_NUM_FDS; ++i) {
+        if (client->fds[i] >= 0) {
+            close(client->fds[i]);
+        }
+    }
+    free(client->strings);
+    free(client);
+}
+
+/*
+ * Pass the command lines of the shell to a shell server, and wait for their
+ * exit status. SIGINT, SIGQUIT, SIGTERM and SIGHUP are passed on to the
+ * session while it is running.
+ *
+ * PARAMETERS
+ *     socket_path: The path of the socket on which the server listens.
+ *     args: The arguments of the shell (not including the name of the shell).
+ *         MUST be terminated by a null entry.
+ *
+ * RETURN VALUE
+ * The exit status of the session, or -1 if no server is listening (in which
+ * case the command lines should be executed by this shell instead).
+ */
+int client_run(const char * socket_path, char ** args) {
+    struct sockaddr_un address; // the address of the server
+    server_request request; // the request to the server
+    const int fds[SERVER_NUM_FDS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO}; // the file descriptors passed to the server
+    struct sigaction action; // the handler of the signals passed to the server
+    sigset_t signals; // the signals passed to the server
+    sigset_t mask; // the signal mask of the shell
+    struct pollfd status_ready; // waits for the exit status
+    char * cwd; // current working directory
+    char * strings; // the strings of the request
+    char * string; // working pointer through strings
+    char ** arg; // working pointer through args and environ
+    int32_t status; // the exit status of the session
+    size_t received = 0; // number of bytes of status which have been received
+    ssize_t bytes; // number of bytes received
+    int fd; // the connection to the server
+
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    for (unsigned int i = 0; i < SERVER_NUM_FDS; ++i) {
+        if (fcntl(fds[i], F_GETFD) < 0) {
+            return -1; // the session would not be able to use the file descriptor
+        }
+    }
+
+    // Build the request
+    if (!(cwd = getcwd(NULL, (size_t) 0))) {
+        return -1;
+    }
+    memset(&request, 0, sizeof(request));
+    request.magic = SERVER_MAGIC;
+    request.length = (uint32_t) (strlen(cwd) + 1);
+    for (arg = args; *arg; arg++) {
+        request.num_args++;
+        request.length += (uint32_t) (strlen(*arg) + 1);
+    }
+    for (arg = environ; *arg; arg++) {
+        request.num_env++;
+        request.length += (uint32_t) (strlen(*arg) + 1);
+    }
+    if (request.length > SERVER_MAX_REQUEST) {
+        free(cwd);
+        return -1;
+    }
+
+    // Memory allocation
+    if (!(strings = (char *) malloc((size_t) request.length))) sys_err("malloc"); // attempt to allocate memory for the strings of the request
+
+    string = stpcpy(strings, cwd) + 1;
+    for (arg = args; *arg; arg++) {
+        string = stpcpy(string, *arg) + 1;
+    }
+    for (arg = environ; *arg; arg++) {
+        string = stpcpy(string, *arg) + 1;
+    }
+    free(cwd);
+
+    // Connect to the server
+    if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) sys_err("socket"); // attempt to create the socket
+    if (connect(fd, (struct sockaddr *) &address, sizeof(address))) {
+        free(strings);
+        close(fd);
+        return -1;
+    }
+
+    // Send the request
+    if (send_all(fd, (const char *) &request, sizeof(request), fds, SERVER_NUM_FDS) || send_all(fd, strings, (size_t) request.length, NULL, 0)) {
+        error_server(socket_path, strerror(errno));
+        free(strings);
+        close(fd);
+        return EXIT_FAILURE;
+    }
+    free(strings);
+
+    // Pass signals to the session while waiting for its exit status
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGQUIT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    sigprocmask(SIG_BLOCK, &signals, &mask);
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = client_signal_handler;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGQUIT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGHUP, &action, NULL);
+
+    status_ready.fd = fd;
+    status_ready.events = POLLIN;
+    while (received < sizeof(status)) {
+        // The signals are only delivered while waiting, so that none of them is missed
+        if (ppoll(&status_ready, (nfds_t) 1, NULL, &mask) < 0) {
+            if (errno != EINTR) sys_err("ppoll");
+            if (client_signal) {
+                const unsigned char signal_number = (unsigned char) client_signal; // the signal to pass to the session
+
+                client_signal = 0;
+                send(fd, &signal_number, sizeof(signal_number), MSG_NOSIGNAL);
+            }
+            continue;
+        }
+
+        if ((bytes = recv(fd, (char *) &status + received, sizeof(status) - received, 0)) <= 0) {
+            if ((bytes < 0) && (errno == EINTR)) {
+                continue;
+            }
+            error_server(socket_path, "The session ended unexpectedly");
+            status = EXIT_FAILURE;
+            break;
+        }
+        received += (size_t) bytes;
+    }
+    close(fd);
+
+    return (int) status;
+}
+
+/*
+ * Record a signal received by the client, so that it can be passed to the
+ * session which is executing the command lines of the client.
+ *
+ * PARAMETERS
+ *     signal_number: The signal.
+ */
+void client_signal_handler(int signal_number) {
+    client_signal = (sig_atomic_t) signal_number;
+}
+
+/*
+ * Display an error message that the server or client failed.
+ *
+ * PARAMETERS
+ *     subject: What the server or client was using when it failed.
+ *     reason: The reason for the failure.
+ */
+void error_server(const char * subject, const char * reason) {
+    // Create error message
+    const char msg[] = "Shell server error '%s': %s.";
+    char * err_msg;
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(subject) + strlen(reason) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, subject, reason);
+    err(err_msg);
+}
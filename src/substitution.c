@@ -0,0 +1,212 @@
+/*
+ * substitution.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains command substitution. The command is executed by the
+ * shell itself (see execute_line) with stdout connected to a pipe, so internal
+ * commands such as echo are executed without creating a child process, and
+ * external commands write straight to the pipe. No temporary file is used. A
+ * command which would change the state of the shell (such as cd, exec or a
+ * variable assignment) is executed in a child process instead.
+ *
+ * The pipe is read by a separate thread while the command is executed, so that
+ * a command which writes more than the pipe can hold does not wait forever for
+ * the shell to read it. The output is read into a buffer which is doubled in
+ * size whenever it becomes full.
+ */
+
+#include "../inc/substitution.h"
+
+/*
+ * Execute a command and capture its output. The command is split into
+ * arguments and executed as a command line (it may contain pipelines and
+ * command lists). Internal commands are executed by the shell itself, unless
+ * the command line uses one which changes the state of the shell or assigns a
+ * variable (see is_barrier_line). Such a command line is executed in a child
+ * process, so that it cannot change the current working directory or the
+ * variables of the shell, replace the shell or make it quit.
+ *
+ * Trailing newline characters are removed from the output, as are any null
+ * characters (which cannot be part of an argument).
+ *
+ * PARAMETERS
+ *     a: The arena from which to allocate the arguments of the command and its
+ *         output.
+ *     command: The command (which need not be null-terminated).
+ *     length: The length of the command.
+ *     output_length: Set to the length of the output.
+ *
+ * RETURN VALUE
+ * A pointer to the null-terminated output of the command.
+ */
+char * command_substitution(arena * a, const char * command, const size_t length, size_t * output_length) {
+    const process_information proc_info_save = proc_info; // to save and restore the process information
+    const redirection_table redirects_save = redirects; // to save and restore the redirections
+    const char * const command_line_save = command_line; // to save and restore the command line being executed
+    const size_t command_line_length_save = command_line_length; // to save and restore the length of the command line being executed
+    const boolean last_line_save = last_line; // to save and restore last_line
+    substitution_capture capture; // the output of the command
+    pthread_t thread; // thread which reads the output of the command
+    sigset_t mask; // all signals
+    sigset_t old_mask; // the signal mask to restore
+    int error; // error number returned by pthread_create
+    int pipe_fds[2]; // pipe to which the command writes
+    int stdout_save; // to save and restore stdout (-1 if stdout was closed)
+    char ** args; // the arguments of the command
+    pid_t pid; // process ID of the child process executing the command
+    job * j; // the job of the child process
+    char * output; // the output of the command
+    char * q; // next character of output
+    size_t end; // length of the output, without trailing newline characters
+
+    if (pipe2(pipe_fds, O_CLOEXEC)) sys_err("pipe2"); // attempt to create a pipe
+
+    // Start reading the output before the command is executed
+    capture.fd = pipe_fds[0];
+    arena_init(&capture.memory);
+    capture.capacity = SUBSTITUTION_READ_SIZE;
+    capture.buffer = (char *) arena_alloc(&capture.memory, capture.capacity); // allocate memory for the buffer from the arena of the capture
+    capture.length = 0;
+
+    // The thread inherits the signal mask, so that signals are handled by the shell
+    sigfillset(&mask);
+    pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+    if ((error = pthread_create(&thread, NULL, substitution_thread, &capture))) {
+        errno = error;
+        sys_err("pthread_create");
+    }
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    // Connect stdout to the pipe
+    writer_flush(&shell_output);
+    stdout_save = fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, 0);
+    dup2(pipe_fds[1], STDOUT_FILENO);
+    close(pipe_fds[1]);
+
+    // The command is a command line of its own, which is never the last of the input
+    redirects.num_entries = 0;
+    redirects.num_opened = 0;
+    command_line = command;
+    command_line_length = length;
+    last_line = FALSE;
+
+    args = tokenize_line(a, command, length);
+    if (!is_barrier_line(args)) {
+        execute_line(args);
+    } else {
+        switch (pid = fork()) {
+            case -1: // fork failed
+                error_launch(*args);
+                last_status = EXIT_FAILURE;
+                break;
+
+            case 0: // child
+                // The jobs of the shell are not children of this process
+                jobs_clear();
+                last_line = TRUE; // the process exits after this command line
+
+                execute_line(args);
+                jobs_wait_all();
+                writer_flush(&shell_output);
+                fflush(stderr);
+                _exit(last_status);
+
+            default: // parent
+                j = job_create(command, length);
+                job_add_process(j, pid);
+                last_status = job_exit_status(job_wait(j, FALSE));
+        }
+    }
+
+    // Restore stdout, which closes the write end of the pipe
+    writer_flush(&shell_output);
+    if (stdout_save >= 0) {
+        dup2(stdout_save, STDOUT_FILENO);
+        close(stdout_save);
+    } else {
+        close(STDOUT_FILENO);
+    }
+
+    proc_info = proc_info_save;
+    redirects = redirects_save;
+    command_line = command_line_save;
+    command_line_length = command_line_length_save;
+    last_line = last_line_save;
+
+    // Wait for the rest of the output (from any command still running in the background)
+    pthread_join(thread, NULL);
+    close(pipe_fds[0]);
+
+    // Remove trailing newline characters
+    for (end = capture.length; end && (capture.buffer[end - 1] == '\n'); end--);
+
+    // Memory allocation
+    output = (char *) arena_alloc(a, (size_t) ((end + 1 /* for null character */) * sizeof(char))); // allocate memory for output from the arena
+
+    // Copy the output, without null characters
+    q = output;
+    for (const char * p = capture.buffer; p < capture.buffer + end; p++) {
+        if (*p) {
+            *q++ = *p;
+        }
+    }
+    *q = '\0';
+    *output_length = (size_t) (q - output);
+
+    arena_free(&capture.memory);
+#ifdef DEBUG
+
+    if (debug) {
+        // Create debug message
+        const char msg[] = "Captured %lu bytes of output from command substitution '%.*s'.";
+        char * dbg_msg;
+
+        // Memory allocation
+        dbg_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + 20 /* for number of bytes */ + length + 1 /* for null character */) * sizeof(char))); // allocate memory for dbg_msg from the line arena
+
+        // Output debug message
+        sprintf(dbg_msg, msg, (unsigned long) *output_length, (int) length, command);
+        debug_message(dbg_msg);
+    }
+#endif // #ifdef DEBUG
+
+    return output;
+}
+
+/*
+ * Read the output of a command substitution until every process which may
+ * write to the pipe has closed it. The buffer is doubled in size whenever it
+ * becomes full, so that each read is as large as possible.
+ *
+ * PARAMETERS
+ *     data: The capture (a substitution_capture) to which the output is read.
+ *
+ * RETURN VALUE
+ * Always null.
+ */
+void * substitution_thread(void * data) {
+    substitution_capture * capture = (substitution_capture *) data; // the capture
+    char * buffer; // the larger buffer
+    ssize_t bytes; // number of bytes read
+
+    while (TRUE) {
+        if (capture->length == capture->capacity) {
+            // Memory allocation
+            buffer = (char *) arena_alloc(&capture->memory, capture->capacity * 2); // allocate memory for the larger buffer from the arena of the capture
+
+            memcpy(buffer, capture->buffer, capture->length);
+            capture->buffer = buffer;
+            capture->capacity *= 2;
+        }
+
+        if ((bytes = read(capture->fd, capture->buffer + capture->length, capture->capacity - capture->length)) > 0) {
+            capture->length += (size_t) bytes;
+        } else if (!bytes || (errno != EINTR)) {
+            break;
+        }
+    }
+
+    return NULL;
+}
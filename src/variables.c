@@ -0,0 +1,617 @@
+/*
+ * variables.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the variables of the shell. The environment of the shell
+ * is imported when the shell starts, and the exported variables are used as
+ * the environment of child processes (see build_environment), so that there
+ * is a single store for both.
+ *
+ * The variables are kept in an array in the order in which they were created,
+ * so that the environment keeps its order. They are found through a hash index
+ * using open addressing (with linear probing), which holds the position of
+ * each variable in the array. The index is rebuilt (and unset variables are
+ * removed from the array) when it becomes half full.
+ *
+ * Each variable is stored as a single "name=value" string, so that the
+ * environment of a child process can refer to the strings without copying
+ * them.
+ */
+
+#include "../inc/variables.h"
+
+variable * variables = NULL; // the variables, in the order in which they were created
+unsigned int num_variables = 0; // number of entries of variables which are used (including unset variables)
+unsigned int variables_capacity = 0; // number of entries allocated for variables
+unsigned int num_exported = 0; // number of exported variables
+int * variable_index = NULL; // the hash index (each slot is a position in variables, VARIABLE_EMPTY or VARIABLE_REMOVED)
+unsigned int variable_index_size = 0; // number of slots in variable_index
+unsigned long variables_generation = 0; // incremented whenever the exported variables change
+
+/*
+ * Import the environment variables of the shell. Every environment variable is
+ * exported. This must be called once before any variable is used.
+ */
+void variables_setup(void) {
+    char ** env; // working pointer through environ
+    const char * separator; // the '=' character of the environment variable
+
+    variables_rehash(VARIABLE_INDEX_SIZE);
+
+    for (env = environ; *env; env++) {
+        if ((separator = strchr(*env, ASSIGNMENT_CHARACTER))) {
+            variable_set(*env, (size_t) (separator - *env), separator + 1, TRUE);
+        }
+    }
+}
+
+/*
+ * Free the memory used by the variables.
+ */
+void variables_free(void) {
+    for (unsigned int i = 0; i < num_variables; ++i) {
+        free(variables[i].string);
+    }
+    free(variables);
+    free(variable_index);
+
+    variables = NULL;
+    variable_index = NULL;
+    num_variables = 0;
+    variables_capacity = 0;
+    variable_index_size = 0;
+    num_exported = 0;
+    variables_generation++;
+}
+
+/*
+ * Calculate the hash of a variable name, using the FNV-1a algorithm.
+ *
+ * PARAMETERS
+ *     name: The variable name (which need not be null-terminated).
+ *     length: The length of the variable name.
+ *
+ * RETURN VALUE
+ * The hash of the name.
+ */
+unsigned int variable_hash(const char * name, const size_t length) {
+    unsigned int hash = 2166136261u; // FNV offset basis
+
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (unsigned char) name[i];
+        hash *= 16777619u; // FNV prime
+    }
+
+    return hash;
+}
+
+/*
+ * Find the hash index slot of a variable. If the variable does not exist, the
+ * slot in which it should be added is returned instead.
+ *
+ * PARAMETERS
+ *     name: The variable name (which need not be null-terminated).
+ *     length: The length of the variable name.
+ *
+ * RETURN VALUE
+ * A pointer to the slot. The slot holds the position of the variable in
+ * variables if it exists, otherwise VARIABLE_EMPTY or VARIABLE_REMOVED.
+ */
+int * variable_slot(const char * name, const size_t length) {
+    const unsigned int mask = variable_index_size - 1; // variable_index_size is a power of two
+    unsigned int i = variable_hash(name, length) & mask; // the current slot
+    int * removed = NULL; // the first slot of an unset variable
+
+    for (;; i = (i + 1) & mask) {
+        if (variable_index[i] == VARIABLE_EMPTY) {
+            return removed ? removed : &variable_index[i];
+        } else if (variable_index[i] == VARIABLE_REMOVED) {
+            if (!removed) {
+                removed = &variable_index[i];
+            }
+        } else if ((variables[variable_index[i]].name_length == length) && !memcmp(variables[variable_index[i]].string, name, length)) {
+            return &variable_index[i];
+        }
+    }
+}
+
+/*
+ * Get the value of a variable.
+ *
+ * PARAMETERS
+ *     name: The variable name (which need not be null-terminated).
+ *     length: The length of the variable name.
+ *
+ * RETURN VALUE
+ * A pointer to the null-terminated value of the variable, or null if the
+ * variable is not set. The value belongs to the variable, and is only valid
+ * until the variable is next changed.
+ */
+const char * variable_get(const char * name, const size_t length) {
+    const int * slot = variable_slot(name, length); // the slot of the variable
+
+    if (*slot < 0) {
+        return NULL;
+    }
+
+    return variables[*slot].string + length + 1 /* for '=' */;
+}
+
+/*
+ * Set the value of a variable, creating the variable if it does not exist.
+ *
+ * PARAMETERS
+ *     name: The variable name (which need not be null-terminated).
+ *     length: The length of the variable name.
+ *     value: The null-terminated value of the variable.
+ *     export: Should the variable be exported? A variable which is already
+ *         exported remains exported.
+ */
+void variable_set(const char * name, const size_t length, const char * value, const boolean export) {
+    int * slot = variable_slot(name, length); // the slot of the variable
+    variable * var; // the variable
+    char * string; // the new "name=value" string
+
+    // Memory allocation
+    if (!(string = (char *) malloc((size_t) ((length + 1 /* for '=' */ + strlen(value) + 1 /* for null character */) * sizeof(char))))) sys_err("malloc"); // attempt to allocate memory for string
+    memcpy(string, name, length);
+    string[length] = ASSIGNMENT_CHARACTER;
+    strcpy(string + length + 1, value);
+
+    if (*slot >= 0) {
+        var = &variables[*slot];
+        free(var->string);
+    } else {
+        // Keep the hash index at most half full
+        if (2 * (num_variables + 1) > variable_index_size) {
+            variables_rehash(2 * variable_index_size);
+            slot = variable_slot(name, length);
+        }
+
+        // Memory allocation
+        if (num_variables == variables_capacity) {
+            variables_capacity = variables_capacity ? 2 * variables_capacity : VARIABLE_INDEX_SIZE;
+            if (!(variables = (variable *) realloc(variables, (size_t) (variables_capacity * sizeof(variable))))) sys_err("realloc"); // attempt to reallocate memory for variables
+        }
+
+        *slot = (int) num_variables;
+        var = &variables[num_variables++];
+        var->name_length = length;
+        var->exported = FALSE;
+    }
+
+    var->string = string;
+    if (export && !var->exported) {
+        var->exported = TRUE;
+        num_exported++;
+    }
+    if (var->exported) {
+        variables_generation++;
+    }
+}
+
+/*
+ * Mark a variable to be exported to child processes. Nothing is done if the
+ * variable is not set.
+ *
+ * PARAMETERS
+ *     name: The variable name (which need not be null-terminated).
+ *     length: The length of the variable name.
+ */
+void variable_export(const char * name, const size_t length) {
+    const int * slot = variable_slot(name, length); // the slot of the variable
+
+    if ((*slot >= 0) && !variables[*slot].exported) {
+        variables[*slot].exported = TRUE;
+        num_exported++;
+        variables_generation++;
+    }
+}
+
+/*
+ * Remove a variable. Nothing is done if the variable is not set.
+ *
+ * PARAMETERS
+ *     name: The variable name (which need not be null-terminated).
+ *     length: The length of the variable name.
+ */
+void variable_unset(const char * name, const size_t length) {
+    int * slot = variable_slot(name, length); // the slot of the variable
+    variable * var; // the variable
+
+    if (*slot < 0) {
+        return;
+    }
+
+    var = &variables[*slot];
+    if (var->exported) {
+        num_exported--;
+        variables_generation++;
+    }
+    free(var->string);
+    var->string = NULL;
+    *slot = VARIABLE_REMOVED;
+}
+
+/*
+ * Rebuild the hash index with a new number of slots. The variables which have
+ * been unset are removed from variables.
+ *
+ * PARAMETERS
+ *     size: The number of slots (which must be a power of two).
+ */
+void variables_rehash(const unsigned int size) {
+    unsigned int num_set = 0; // number of variables which are set
+
+    // Remove the unset variables, keeping the order of the others
+    for (unsigned int i = 0; i < num_variables; ++i) {
+        if (variables[i].string) {
+            variables[num_set++] = variables[i];
+        }
+    }
+    num_variables = num_set;
+
+    // Memory allocation
+    free(variable_index);
+    if (!(variable_index = (int *) malloc((size_t) (size * sizeof(int))))) sys_err("malloc"); // attempt to allocate memory for variable_index
+    variable_index_size = size;
+
+    for (unsigned int i = 0; i < size; ++i) {
+        variable_index[i] = VARIABLE_EMPTY;
+    }
+    for (unsigned int i = 0; i < num_variables; ++i) {
+        *variable_slot(variables[i].string, variables[i].name_length) = (int) i;
+    }
+}
+
+/*
+ * Build an environment for a child process from the exported variables. The
+ * environment refers to the strings of the variables, so it must not be used
+ * once the exported variables have changed (see variables_generation).
+ *
+ * The memory allocated by this function must be freed by the caller (but not
+ * the strings to which the environment refers).
+ *
+ * PARAMETERS
+ *     extra: A "name=value" string to be placed first in the environment,
+ *         replacing any exported variable with the same name (or null).
+ *
+ * RETURN VALUE
+ * A pointer to a null-terminated array of environment strings.
+ */
+char ** variables_environment(char * extra) {
+    const size_t extra_length = extra ? strcspn(extra, "=") : 0; // length of the name of the extra variable
+    char ** envp; // the environment
+    char ** e; // working pointer through envp
+
+    // Memory allocation
+    if (!(envp = (char **) malloc((size_t) ((num_exported + 1 /* for extra */ + 1 /* for null element */) * sizeof(char *))))) sys_err("malloc"); // attempt to allocate memory for envp
+
+    e = envp;
+    if (extra) {
+        *e++ = extra;
+    }
+    for (unsigned int i = 0; i < num_variables; ++i) {
+        if (variables[i].string && variables[i].exported && !(extra && (variables[i].name_length == extra_length) && !memcmp(variables[i].string, extra, extra_length))) {
+            *e++ = variables[i].string;
+        }
+    }
+    *e = NULL;
+
+    return envp;
+}
+
+/*
+ * Print the exported variables, in the order in which they were created.
+ *
+ * PARAMETERS
+ *     out: The writer to print to.
+ */
+void variables_print(writer * out) {
+    for (unsigned int i = 0; i < num_variables; ++i) {
+        if (variables[i].string && variables[i].exported) {
+            writer_puts(out, variables[i].string);
+            writer_write(out, "\n", 1);
+        }
+    }
+}
+
+/*
+ * Find the length of the variable name at the start of a string. A variable
+ * name consists of letters, digits and underscores, and does not start with a
+ * digit.
+ *
+ * PARAMETERS
+ *     string: A null-terminated string.
+ *
+ * RETURN VALUE
+ * The length of the variable name, or 0 if the string does not start with a
+ * variable name.
+ */
+size_t variable_name_length(const char * string) {
+    size_t length = 0; // length of the name
+
+    if ((*string != '_') && !isalpha((unsigned char) *string)) {
+        return 0;
+    }
+
+    while ((string[length] == '_') || isalnum((unsigned char) string[length])) {
+        length++;
+    }
+
+    return length;
+}
+
+/*
+ * Check whether an argument is a variable assignment (a variable name followed
+ * by ASSIGNMENT_CHARACTER).
+ *
+ * PARAMETERS
+ *     arg: An argument returned by lexer_next.
+ *
+ * RETURN VALUE
+ * TRUE if the argument is a variable assignment, otherwise FALSE.
+ */
+boolean is_assignment(const char * arg) {
+    const size_t length = variable_name_length(arg); // length of the variable name
+
+    return length && (arg[length] == ASSIGNMENT_CHARACTER);
+}
+
+/*
+ * Expand the variables and command substitutions in an argument.
+ * EXPANSION_CHARACTER followed by a variable name (optionally between
+ * EXPANSION_OPEN and EXPANSION_CLOSE) is replaced by the value of the variable
+ * (nothing if the variable is not set), EXPANSION_CHARACTER followed by
+ * STATUS_VARIABLE is replaced by the exit status of the last command executed,
+ * and EXPANSION_CHARACTER followed by a command between SUBSTITUTION_OPEN and
+ * SUBSTITUTION_CLOSE is replaced by the output of the command (see
+ * command_substitution). Any other EXPANSION_CHARACTER is left unchanged.
+ *
+ * If num_fields is not null, the output of each command substitution is split
+ * into fields at SEPARATORS. The fields are stored one after the other, each
+ * null-terminated and preceded by its flags (as the lexer stores tokens), and
+ * empty fields are removed.
+ *
+ * The expanded argument is marked as quoted, so that a value which contains
+ * (for example) the pipe character does not become an operator.
+ *
+ * PARAMETERS
+ *     a: The arena from which to allocate the expanded argument.
+ *     arg: An argument returned by lexer_next.
+ *     num_fields: Set to the number of fields, or null if the argument should
+ *         not be split into fields.
+ *
+ * RETURN VALUE
+ * A pointer to the expanded argument (the first field, if it was split).
+ */
+char * expand_token(arena * a, const char * arg, unsigned int * num_fields) {
+    const char * end = arg + strlen(arg); // end of the argument
+    char status[16]; // the exit status of the last command, as a string
+    command_output * outputs = NULL; // the outputs of the command substitutions, in order
+    command_output ** last_output = &outputs; // where the next output should be stored
+    token_writer writer; // the expanded argument
+    char * flags = NULL; // the flags of the expanded argument
+
+    sprintf(status, "%d", last_status);
+    writer.output = NULL;
+    writer.length = 0;
+    writer.flags = (char) ((arg[-1] & ~TOKEN_EXPAND) | TOKEN_QUOTED);
+
+    // The first pass measures the expanded argument (and executes the command substitutions), and the second copies it
+    for (unsigned int pass = 0; pass < 2; ++pass) {
+        const char * p = arg; // the current character
+        command_output * substitution = outputs; // the output of the next command substitution (in the second pass)
+        size_t run; // length of a run of characters which are copied unchanged
+
+        writer.num_fields = 0;
+        writer.in_field = FALSE;
+
+        while (*p) {
+            const char * value; // the value to insert
+            size_t name_length; // length of the variable name
+
+            if (*p != EXPANSION_CHARACTER) {
+                // Copy ordinary characters
+                for (run = 1; p[run] && (p[run] != EXPANSION_CHARACTER); run++);
+                token_write(&writer, p, run, FALSE, FALSE);
+                p += run;
+                continue;
+            }
+
+            if (p[1] == STATUS_VARIABLE) {
+                value = status;
+                p += 2;
+            } else if ((run = lexer_substitution_length(p, end))) {
+                if (!pass) {
+                    // Memory allocation
+                    substitution = (command_output *) arena_alloc(a, sizeof(command_output)); // allocate memory for substitution from the arena
+
+                    // Execute the command only once, keeping its output for the second pass
+                    substitution->output = command_substitution(a, p + 2 /* for EXPANSION_CHARACTER and SUBSTITUTION_OPEN */, run - 3 /* for SUBSTITUTION_CLOSE */, &substitution->length);
+                    substitution->next = NULL;
+                    *last_output = substitution;
+                    last_output = &substitution->next;
+                }
+                token_write(&writer, substitution->output, substitution->length, num_fields != NULL, TRUE);
+                substitution = substitution->next;
+                p += run;
+                continue;
+            } else if ((p[1] == EXPANSION_OPEN) && (name_length = variable_name_length(p + 2)) && (p[2 + name_length] == EXPANSION_CLOSE)) {
+                value = variable_get(p + 2, name_length);
+                p += name_length + 3;
+            } else if ((name_length = variable_name_length(p + 1))) {
+                value = variable_get(p + 1, name_length);
+                p += name_length + 1;
+            } else {
+                // Copy a character which does not start an expansion
+                token_write(&writer, p, 1, FALSE, FALSE);
+                p++;
+                continue;
+            }
+
+            if (value) {
+                token_write(&writer, value, strlen(value), FALSE, TRUE);
+            }
+        }
+
+        if (!pass) {
+            // Memory allocation
+            flags = (char *) arena_alloc(a, (size_t) ((1 /* for flags */ + writer.length + 1 /* for null character */) * sizeof(char))); // allocate memory for the expanded argument from the arena
+            *flags = writer.flags;
+            writer.output = flags + 1;
+        }
+    }
+    *writer.output = '\0';
+
+    if (num_fields) {
+        *num_fields = writer.num_fields;
+    }
+
+    return flags + 1;
+}
+
+/*
+ * Write part of an expanded argument (see expand_token), or measure it if the
+ * writer has no output yet. If the part should be split into fields, each run
+ * of SEPARATORS in it ends the current field, and the next character which is
+ * written starts a new field.
+ *
+ * A value inserted into a pathname pattern has its GLOB_ESCAPE characters
+ * escaped, so that they only match themselves (its wildcards remain wildcards).
+ *
+ * PARAMETERS
+ *     writer: The expanded argument.
+ *     part: The characters to write.
+ *     length: The number of characters to write.
+ *     split: Should the part be split into fields?
+ *     value: Is the part a value (of a variable or command substitution)
+ *         rather than characters of the argument itself?
+ */
+void token_write(token_writer * writer, const char * part, const size_t length, const boolean split, const boolean value) {
+    const char * p = part; // the current character
+    const char * end = part + length; // end of the part
+    const char * start; // start of the current run of characters within a field
+
+    while (p < end) {
+        if (split) {
+            // Skip separators, which end the current field
+            while ((p < end) && strchr(SEPARATORS, *p)) {
+                writer->in_field = FALSE;
+                p++;
+            }
+            if (p == end) {
+                break;
+            }
+        }
+
+        if (!writer->in_field) {
+            // Start a new field, after the null character and flags ending the previous field
+            if (writer->num_fields) {
+                if (writer->output) {
+                    *writer->output++ = '\0';
+                    *writer->output++ = writer->flags;
+                } else {
+                    writer->length += 2;
+                }
+            }
+            writer->num_fields++;
+            writer->in_field = TRUE;
+        }
+
+        // Find the end of the characters which belong to the current field
+        start = p;
+        if (split) {
+            while ((p < end) && !strchr(SEPARATORS, *p)) {
+                p++;
+            }
+        } else {
+            p = end;
+        }
+
+        if (value && (writer->flags & TOKEN_GLOB)) {
+            // Copy the characters one at a time, escaping GLOB_ESCAPE
+            for (const char * c = start; c < p; c++) {
+                if (writer->output) {
+                    if (*c == GLOB_ESCAPE) {
+                        *writer->output++ = GLOB_ESCAPE;
+                    }
+                    *writer->output++ = *c;
+                } else {
+                    writer->length += (*c == GLOB_ESCAPE) ? 2 : 1;
+                }
+            }
+        } else if (writer->output) {
+            memcpy(writer->output, start, (size_t) (p - start));
+            writer->output += p - start;
+        } else {
+            writer->length += (size_t) (p - start);
+        }
+    }
+}
+
+/*
+ * Expand the variables and command substitutions in the arguments of a command
+ * (see expand_token). Only the arguments marked by the lexer as containing
+ * EXPANSION_CHARACTER are examined. The output of a command substitution in an
+ * argument without quotation marks is split into separate arguments, and an
+ * argument without quotation marks which expands to nothing is removed.
+ *
+ * PARAMETERS
+ *     a: The arena from which to allocate the expanded arguments.
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *
+ * RETURN VALUE
+ * A pointer to an array of the expanded arguments, terminated by a null entry.
+ * This is args itself if no argument needed to be expanded.
+ */
+char ** expand_arguments(arena * a, char ** args) {
+    char ** arg; // working pointer through args
+    char ** expanded; // the expanded arguments
+    char ** output; // where the next argument should be stored
+    unsigned int * num_fields; // number of fields of each argument
+    unsigned int num_args = 0; // number of arguments
+    unsigned int num_expanded = 0; // number of expanded arguments
+    boolean found = FALSE; // does any argument need to be expanded?
+
+    for (arg = args; *arg; arg++) {
+        num_args++;
+        if ((*arg)[-1] & TOKEN_EXPAND) {
+            found = TRUE;
+        }
+    }
+
+    if (!found) {
+        return args;
+    }
+
+    // Memory allocation
+    num_fields = (unsigned int *) arena_alloc(a, (size_t) (num_args * sizeof(unsigned int))); // allocate memory for num_fields from the arena
+
+    for (unsigned int i = 0; i < num_args; ++i) {
+        num_fields[i] = 1;
+        if (args[i][-1] & TOKEN_EXPAND) {
+            args[i] = expand_token(a, args[i], is_unquoted(args[i]) ? &num_fields[i] : NULL);
+        }
+        num_expanded += num_fields[i];
+    }
+
+    // Memory allocation
+    expanded = (char **) arena_alloc(a, (size_t) ((num_expanded + 1 /* for null element */) * sizeof(char *))); // allocate memory for expanded from the arena
+
+    output = expanded;
+    for (unsigned int i = 0; i < num_args; ++i) {
+        char * field = args[i]; // the current field of the argument
+
+        for (unsigned int j = 0; j < num_fields[i]; ++j) {
+            *output++ = field;
+            field += strlen(field) + 2 /* for null character and flags of the next field */;
+        }
+    }
+    *output = NULL;
+
+    return expanded;
+}
@@ -0,0 +1,182 @@
+/*
+ * writer.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the buffered output of the shell. Everything which the
+ * shell itself writes to stdout (the output of internal commands, job
+ * notifications, the prompt and debug messages) is collected in one large
+ * buffer, so that the output of consecutive internal commands is usually
+ * written with a single system call.
+ *
+ * The buffer is written when it becomes full, before the shell waits for input
+ * or for a job, before stdout is redirected or restored, before a child process
+ * is created and before an error message is displayed, so that output always
+ * appears in the order in which it was produced. Output which does not fit in
+ * the buffer is written together with the buffer by writev, rather than being
+ * copied into it.
+ */
+
+#include "../inc/writer.h"
+
+writer shell_output = {STDOUT_FILENO, 0, {0}}; // the output of the shell (stdout)
+
+/*
+ * Add bytes to the output of a writer. The bytes are copied into the buffer if
+ * they fit, and otherwise written immediately after the buffered output.
+ *
+ * PARAMETERS
+ *     w: The writer.
+ *     data: The bytes to add.
+ *     length: The number of bytes to add.
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned and errno is set to indicate the
+ * error.
+ */
+int writer_write(writer * w, const char * data, const size_t length) {
+    if (length > WRITER_BUFFER_SIZE - w->used) {
+        return writer_flush_with(w, data, length);
+    }
+
+    memcpy(w->data + w->used, data, length);
+    w->used += length;
+
+    return 0;
+}
+
+/*
+ * Add a string to the output of a writer.
+ *
+ * PARAMETERS
+ *     w: The writer.
+ *     s: A null-terminated string.
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned and errno is set to indicate the
+ * error.
+ */
+int writer_puts(writer * w, const char * s) {
+    return writer_write(w, s, strlen(s));
+}
+
+/*
+ * Add formatted output (in the same format as printf) to the output of a
+ * writer. The output is formatted directly into the buffer where possible.
+ *
+ * PARAMETERS
+ *     w: The writer.
+ *     format: The format string, followed by the values to format.
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned and errno is set to indicate the
+ * error.
+ */
+int writer_printf(writer * w, const char * format, ...) {
+    va_list values; // the values to format
+    char * output; // the formatted output (if it does not fit in the buffer)
+    int length; // length of the formatted output
+    int result; // return value
+
+    // Format the output into the free space of the buffer
+    va_start(values, format);
+    length = vsnprintf(w->data + w->used, WRITER_BUFFER_SIZE - w->used, format, values);
+    va_end(values);
+
+    if (length < 0) {
+        return -1;
+    }
+    if ((size_t) length < WRITER_BUFFER_SIZE - w->used) {
+        w->used += (size_t) length;
+        return 0;
+    }
+
+    // The output does not fit, so format it again into memory of its own
+    va_start(values, format);
+    length = vasprintf(&output, format, values);
+    va_end(values);
+
+    if (length < 0) {
+        return -1;
+    }
+    result = writer_write(w, output, (size_t) length);
+    free(output);
+
+    return result;
+}
+
+/*
+ * Write the buffered output of a writer, followed by some further bytes, to its
+ * file descriptor with as few system calls as possible. The buffer is empty
+ * afterwards, even if the output could not be written.
+ *
+ * PARAMETERS
+ *     w: The writer.
+ *     data: The bytes to write after the buffered output (may be null if
+ *         length is 0).
+ *     length: The number of bytes to write after the buffered output.
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned and errno is set to indicate the
+ * error.
+ */
+int writer_flush_with(writer * w, const char * data, const size_t length) {
+    struct iovec parts[2]; // the buffered output and the further bytes
+    struct iovec * part = parts; // the first part which has not been completely written
+    int num_parts = 2; // the number of parts which have not been completely written
+    ssize_t bytes; // number of bytes written by the last call to writev
+
+    parts[0].iov_base = w->data;
+    parts[0].iov_len = w->used;
+    parts[1].iov_base = (void *) data;
+    parts[1].iov_len = length;
+    w->used = 0;
+
+    while (num_parts) {
+        // Skip the parts which have been written
+        if (!part->iov_len) {
+            part++;
+            num_parts--;
+            continue;
+        }
+
+        if ((bytes = writev(w->fd, part, num_parts)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+
+        // Move past the bytes which were written
+        while (bytes > 0) {
+            if ((size_t) bytes >= part->iov_len) {
+                bytes -= (ssize_t) part->iov_len;
+                part->iov_len = 0;
+                part++;
+                num_parts--;
+            } else {
+                part->iov_base = (char *) part->iov_base + bytes;
+                part->iov_len -= (size_t) bytes;
+                bytes = 0;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Write the buffered output of a writer to its file descriptor. Nothing is
+ * written if the buffer is empty.
+ *
+ * PARAMETERS
+ *     w: The writer.
+ *
+ * RETURN VALUE
+ * 0 on success. On failure, -1 is returned and errno is set to indicate the
+ * error.
+ */
+int writer_flush(writer * w) {
+    return w->used ? writer_flush_with(w, NULL, 0) : 0;
+}
@@ -0,0 +1,485 @@
+/*
+ * zygote.c
+ *
+ * Author: Joshua Spence
+ * SID:    308216350
+ *
+ * This file contains the fork server (or "zygote"). When the shell is started
+ * with ZYGOTE_OPTION, a small helper process is forked from main before any of
+ * the state of the shell (variables, caches, the job table, and so on) has been
+ * built. The shell then passes the path, arguments and environment of each
+ * external program it launches to the fork server over a socket pair, together
+ * with its file descriptors (with SCM_RIGHTS), and the fork server creates the
+ * child process. The cost of creating a child process therefore depends only on
+ * the size of the fork server, however large the shell grows.
+ *
+ * The fork server creates each child process with clone(CLONE_PARENT), so the
+ * child process is a child of the shell rather than of the fork server, and is
+ * waited for (and put in its process group) by the shell exactly as if the
+ * shell had launched it itself. The child process shares the memory of the
+ * fork server until it executes its program (CLONE_VM | CLONE_VFORK), in the
+ * same way as posix_spawn.
+ *
+ * Only the process which started the fork server may use it. Child processes
+ * of the shell (such as a command substitution or a session of a shell server)
+ * launch programs themselves.
+ */
+
+#include "../inc/zygote.h"
+
+int zygote_fd = -1; // the connection to the fork server (-1 if it is not running)
+pid_t zygote_owner; // the process which started the fork server
+boolean zygote_environment_sent = FALSE; // has the environment been sent to the fork server?
+unsigned long zygote_environment_generation; // value of variables_generation when the environment was sent
+long zygote_stack[ZYGOTE_STACK_SIZE / sizeof(long)]; // the stack on which a child process of the fork server runs until it executes its program
+int zygote_error; // error number reported by a child process of the fork server (0 if it executed its program)
+
+/*
+ * Start the fork server. If the fork server cannot be started, an error message
+ * is displayed and the shell launches programs itself.
+ */
+void zygote_start(void) {
+    int fds[2]; // the socket pair connecting the shell and the fork server
+    pid_t pid; // process ID of the fork server
+
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds)) {
+        error_zygote(strerror(errno));
+        return;
+    }
+
+    writer_flush(&shell_output); // otherwise the fork server would write the output of the shell again
+    switch (pid = fork()) {
+        case -1: // fork failed
+            error_zygote(strerror(errno));
+            close(fds[0]);
+            close(fds[1]);
+            break;
+
+        case 0: // child
+            close(fds[0]);
+            zygote_serve(fds[1]);
+            break;
+
+        default: // parent
+            close(fds[1]);
+            zygote_fd = fds[0];
+            zygote_owner = getpid();
+    }
+}
+
+/*
+ * Stop the fork server. The fork server exits when it finds that the shell has
+ * closed its end of the socket pair.
+ */
+void zygote_stop(void) {
+    if (zygote_fd >= 0) {
+        close(zygote_fd);
+        zygote_fd = -1;
+    }
+}
+
+/*
+ * Check whether programs may be launched by the fork server: it must be
+ * running, and this process must be the one which started it (so that the
+ * child processes of the fork server are children of this process).
+ *
+ * RETURN VALUE
+ * TRUE if programs may be launched by the fork server, otherwise FALSE.
+ */
+boolean zygote_running(void) {
+    return (zygote_fd >= 0) && (getpid() == zygote_owner);
+}
+
+/*
+ * Launch a program in a child process by the fork server. The child process
+ * is prepared in the same way as by launch_program: the shell's file
+ * descriptors 0 to REDIRECT_MAX_FD are given to the child process, stdin and
+ * stdout are connected to input_fd and output_fd, the redirections of the
+ * command are applied, and the child process is put in its process group.
+ *
+ * If the fork server cannot be used (because it has exited), it is stopped and
+ * FALSE is returned, so that the program can be launched by the shell instead.
+ *
+ * PARAMETERS
+ *     file: The full path to the program to execute.
+ *     args: A pointer to an array of character strings. MUST be terminated by a
+ *         null entry.
+ *     envp: The environment of the program (see child_environment).
+ *     input_fd: The file descriptor to be used as stdin by the child process,
+ *         or -1 if stdin should not be redirected.
+ *     output_fd: The file descriptor to be used as stdout by the child process,
+ *         or -1 if stdout should not be redirected.
+ *     pgid: The process group for the child process (see launch_program).
+ *     pid: Set to the process ID of the child process on success, or to -1 (with
+ *         errno set to indicate the error) on failure.
+ *
+ * RETURN VALUE
+ * TRUE if the fork server attempted to launch the program, otherwise FALSE.
+ */
+boolean zygote_launch(const char * file, char ** args, char ** envp, const int input_fd, const int output_fd, const pid_t pgid, pid_t * pid) {
+    zygote_request * request; // the request to the fork server
+    zygote_reply reply; // the reply of the fork server
+    int fds[ZYGOTE_MAX_FDS]; // the file descriptors passed to the fork server
+    char * message; // the request, followed by its strings
+    char * string; // working pointer through the strings of the request
+    char ** arg; // working pointer through args and envp
+    size_t length; // length of the strings of the request
+    size_t received = 0; // number of bytes of reply which have been received
+    ssize_t bytes; // number of bytes received
+    int flags; // the file descriptor flags of a file descriptor of the shell
+    const boolean new_environment = !zygote_environment_sent || (zygote_environment_generation != variables_generation); // must the environment be sent?
+
+    // Calculate the length of the strings
+    length = strlen(file) + 1;
+    for (arg = args; *arg; arg++) {
+        length += strlen(*arg) + 1;
+    }
+    if (new_environment) {
+        for (arg = envp; *arg; arg++) {
+            length += strlen(*arg) + 1;
+        }
+    }
+
+    // Memory allocation
+    message = (char *) arena_alloc(&line_arena, sizeof(zygote_request) + length); // allocate memory for message from the line arena
+
+    request = (zygote_request *) message;
+    memset(request, 0, sizeof(zygote_request));
+    request->length = (uint32_t) length;
+    request->new_environment = new_environment;
+    request->pgid = pgid;
+    request->foreground = !proc_info.dont_wait;
+    request->job_control = job_control;
+
+    // Pass the file descriptors of the shell which the program may use
+    for (int fd = 0; fd <= REDIRECT_MAX_FD; ++fd) {
+        if ((flags = fcntl(fd, F_GETFD)) >= 0) {
+            request->open_fds |= 1u << fd;
+            if (flags & FD_CLOEXEC) {
+                request->cloexec_fds |= 1u << fd;
+            }
+            fds[request->num_fds++] = fd;
+        }
+    }
+    request->input_index = (input_fd >= 0) ? (int) request->num_fds : -1;
+    if (input_fd >= 0) {
+        fds[request->num_fds++] = input_fd;
+    }
+    request->output_index = (output_fd >= 0) ? (int) request->num_fds : -1;
+    if (output_fd >= 0) {
+        fds[request->num_fds++] = output_fd;
+    }
+    for (unsigned int i = 0; i < redirects.num_entries; ++i) {
+        request->redirects[i] = redirects.entries[i];
+        request->source_index[i] = -1;
+        if (redirects.entries[i].source >= REDIRECT_SHELL_FD) {
+            request->source_index[i] = (int) request->num_fds;
+            fds[request->num_fds++] = redirects.entries[i].source;
+        }
+    }
+    request->num_redirects = redirects.num_entries;
+
+    // Copy the strings
+    string = stpcpy(message + sizeof(zygote_request), file) + 1;
+    for (arg = args; *arg; arg++) {
+        string = stpcpy(string, *arg) + 1;
+        request->num_args++;
+    }
+    if (new_environment) {
+        for (arg = envp; *arg; arg++) {
+            string = stpcpy(string, *arg) + 1;
+            request->num_env++;
+        }
+    }
+
+    // Send the request and wait for the reply
+    if (send_all(zygote_fd, message, sizeof(zygote_request) + length, fds, request->num_fds)) {
+        zygote_stop();
+        return FALSE;
+    }
+    while (received < sizeof(reply)) {
+        if ((bytes = recv(zygote_fd, (char *) &reply + received, sizeof(reply) - received, 0)) <= 0) {
+            if ((bytes < 0) && (errno == EINTR)) {
+                continue;
+            }
+            zygote_stop();
+            return FALSE;
+        }
+        received += (size_t) bytes;
+    }
+
+    if (new_environment) {
+        zygote_environment_sent = TRUE;
+        zygote_environment_generation = variables_generation;
+    }
+
+    *pid = reply.pid;
+    errno = reply.error;
+    return TRUE;
+}
+
+/*
+ * Handle the requests of the shell until the shell closes its end of the
+ * socket pair, and then exit. This is the main loop of the fork server, so it
+ * never returns.
+ *
+ * PARAMETERS
+ *     fd: The fork server's end of the socket pair.
+ */
+void zygote_serve(const int fd) {
+    zygote_request request; // the request of the shell
+    zygote_reply reply; // the reply to the shell
+    zygote_launch_information launch; // the program to launch
+    int fds[ZYGOTE_MAX_FDS]; // the file descriptors passed with the request
+    unsigned int num_fds; // number of file descriptors passed with the request
+    char * strings = NULL; // the strings of the request
+    size_t strings_size = 0; // size of strings
+    char * environment = NULL; // the environment strings
+    char ** envp = NULL; // the environment of programs
+    char ** args = NULL; // the arguments of the program
+    size_t args_size = 0; // number of entries of args
+    char * string; // working pointer through the strings of the request
+
+    // Terminal signals are meant for the shell and its jobs
+    signal(SIGINT, SIG_IGN);
+    signal(SIGQUIT, SIG_IGN);
+    signal(SIGTSTP, SIG_IGN);
+    signal(SIGTTIN, SIG_IGN);
+    signal(SIGTTOU, SIG_IGN);
+
+    // Memory allocation
+    if (!(envp = (char **) calloc((size_t) 1, sizeof(char *)))) sys_err("calloc"); // attempt to allocate memory for an empty environment
+
+    while (zygote_receive(fd, &request, sizeof(request), fds, &num_fds)) {
+        if ((num_fds != request.num_fds) || !request.length || (request.num_redirects > REDIRECT_MAX)) {
+            break; // the request was not understood
+        }
+
+        // Keep the file descriptors out of the way of those of the program
+        for (unsigned int i = 0; i < num_fds; ++i) {
+            if (fds[i] < REDIRECT_SHELL_FD) {
+                const int moved = fcntl(fds[i], F_DUPFD_CLOEXEC, REDIRECT_SHELL_FD); // the file descriptor at its new position
+
+                close(fds[i]);
+                fds[i] = moved;
+            }
+        }
+
+        // Memory allocation
+        if (request.length > strings_size) {
+            strings_size = request.length;
+            if (!(strings = (char *) realloc(strings, strings_size))) sys_err("realloc"); // attempt to reallocate memory for strings
+        }
+        if (request.num_args + 1 > args_size) {
+            args_size = request.num_args + 1;
+            if (!(args = (char **) realloc(args, args_size * sizeof(char *)))) sys_err("realloc"); // attempt to reallocate memory for args
+        }
+
+        if (!zygote_receive(fd, strings, (size_t) request.length, NULL, NULL)) {
+            break;
+        }
+
+        // Split the strings
+        string = strings;
+        launch.file = string;
+        string += strlen(string) + 1;
+        for (uint32_t i = 0; i < request.num_args; ++i) {
+            args[i] = string;
+            string += strlen(string) + 1;
+        }
+        args[request.num_args] = NULL;
+
+        if (request.new_environment) {
+            // Keep the environment for later requests
+            free(environment);
+            free(envp);
+            if (!(environment = (char *) malloc((size_t) (strings + request.length - string) + 1))) sys_err("malloc"); // attempt to allocate memory for environment
+            if (!(envp = (char **) malloc((size_t) (request.num_env + 1) * sizeof(char *)))) sys_err("malloc"); // attempt to allocate memory for envp
+
+            memcpy(environment, string, (size_t) (strings + request.length - string));
+            string = environment;
+            for (uint32_t i = 0; i < request.num_env; ++i) {
+                envp[i] = string;
+                string += strlen(string) + 1;
+            }
+            envp[request.num_env] = NULL;
+        }
+
+        // Launch the program as a child of the shell
+        launch.request = &request;
+        launch.fds = fds;
+        launch.args = args;
+        launch.envp = envp;
+        job_control = request.job_control; // used by job_child_setup
+        zygote_error = 0;
+
+        reply.pid = clone(zygote_child, (char *) zygote_stack + sizeof(zygote_stack), CLONE_VM | CLONE_VFORK | CLONE_PARENT | SIGCHLD, &launch);
+        reply.error = (reply.pid < 0) ? errno : zygote_error;
+        if (reply.error) {
+            reply.pid = -1; // a child process which failed has already exited (and is reaped by the shell)
+        }
+
+        for (unsigned int i = 0; i < num_fds; ++i) {
+            close(fds[i]);
+        }
+
+        if (send_all(fd, (const char *) &reply, sizeof(reply), NULL, 0)) {
+            break;
+        }
+    }
+
+    _exit(EXIT_SUCCESS);
+}
+
+/*
+ * Receive bytes from the shell, waiting until all of them have been received.
+ * File descriptors passed with the bytes are received as well (close-on-exec).
+ *
+ * PARAMETERS
+ *     fd: The fork server's end of the socket pair.
+ *     data: Where to store the bytes.
+ *     length: The number of bytes to receive.
+ *     fds: Where to store the file descriptors (at least ZYGOTE_MAX_FDS
+ *         entries), or null if none are expected.
+ *     num_fds: Set to the number of file descriptors received (may be null if
+ *         fds is null).
+ *
+ * RETURN VALUE
+ * TRUE on success, or FALSE if the shell has closed its end of the socket pair
+ * (or an error occurred).
+ */
+boolean zygote_receive(const int fd, void * data, size_t length, int * fds, unsigned int * num_fds) {
+    union {
+        struct cmsghdr header;
+        char data[CMSG_SPACE(ZYGOTE_MAX_FDS * sizeof(int))];
+    } control; // the file descriptors passed by the shell
+    struct msghdr message; // the message being received
+    struct iovec part; // where the bytes of the message are stored
+    struct cmsghdr * cmsg; // working pointer through the control messages
+    ssize_t bytes; // number of bytes received
+
+    if (num_fds) {
+        *num_fds = 0;
+    }
+
+    while (length) {
+        part.iov_base = data;
+        part.iov_len = length;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &part;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data;
+        message.msg_controllen = sizeof(control.data);
+
+        if ((bytes = recvmsg(fd, &message, MSG_CMSG_CLOEXEC)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return FALSE;
+        }
+        if (!bytes) {
+            return FALSE;
+        }
+
+        for (cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS)) {
+                const unsigned int received = (unsigned int) ((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int)); // number of file descriptors received
+
+                if (fds && (*num_fds + received <= ZYGOTE_MAX_FDS)) {
+                    memcpy(fds + *num_fds, CMSG_DATA(cmsg), received * sizeof(int));
+                    *num_fds += received;
+                } else {
+                    return FALSE;
+                }
+            }
+        }
+
+        data = (char *) data + bytes;
+        length -= (size_t) bytes;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Prepare a child process of the fork server and execute its program. This is
+ * executed by the child process created by zygote_serve, on zygote_stack and in
+ * the memory of the fork server, so it only uses system calls and reports
+ * failure through zygote_error.
+ *
+ * PARAMETERS
+ *     argument: The program to launch (see zygote_launch_information).
+ *
+ * RETURN VALUE
+ * This function never returns.
+ */
+int zygote_child(void * argument) {
+    const zygote_launch_information * launch = (const zygote_launch_information *) argument; // the program to launch
+    const zygote_request * request = launch->request; // the request of the shell
+    unsigned int next = 0; // index of the next file descriptor of the shell
+
+    // Give the program the file descriptors of the shell
+    for (int fd = 0; fd <= REDIRECT_MAX_FD; ++fd) {
+        if (request->open_fds & (1u << fd)) {
+            dup2(launch->fds[next++], fd);
+            if (request->cloexec_fds & (1u << fd)) {
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+            }
+        } else {
+            close(fd);
+        }
+    }
+
+    job_child_setup(request->pgid, request->foreground);
+
+    // Redirect input if necessary
+    if (request->input_index >= 0) {
+        dup2(launch->fds[request->input_index], STDIN_FILENO);
+    }
+
+    // Redirect output if necessary
+    if (request->output_index >= 0) {
+        dup2(launch->fds[request->output_index], STDOUT_FILENO);
+    }
+
+    // Apply the redirections of the command (see redirect_apply)
+    for (unsigned int i = 0; i < request->num_redirects; ++i) {
+        const redirection * r = &request->redirects[i]; // the current redirection
+
+        if (r->source == r->fd) {
+            continue;
+        }
+
+        if (r->source < 0) {
+            close(r->fd);
+        } else {
+            dup2((request->source_index[i] >= 0) ? launch->fds[request->source_index[i]] : r->source, r->fd);
+        }
+    }
+
+    // Execute the command with the appropriate arguments
+    execve(launch->file, launch->args, launch->envp);
+
+    // If execution reaches this line, an error has occured as execve should never return
+    zygote_error = errno;
+    _exit(ZYGOTE_EXEC_FAILED);
+}
+
+/*
+ * Display an error message that the fork server could not be started.
+ *
+ * PARAMETERS
+ *     reason: The reason for the failure.
+ */
+void error_zygote(const char * reason) {
+    // Create error message
+    const char msg[] = "Unable to start the fork server: %s. Programs will be launched by the shell instead.";
+    char * err_msg;
+
+    // Memory allocation
+    err_msg = (char *) arena_alloc(&line_arena, (size_t) ((strlen(msg) + strlen(reason) + 1 /* for null character */) * sizeof(char))); // allocate memory for err_msg from the line arena
+
+    // Output error message
+    sprintf(err_msg, msg, reason);
+    err(err_msg);
+}
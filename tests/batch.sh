@@ -0,0 +1,51 @@
+#!/bin/sh
+################################################################################
+# Tests of batch files, parallel batches and the fork server of 'myshell'
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Executes batch files with 'myshell' and compares their output with the
+# expected output. A parallel batch must produce the same output as the batch
+# executed one command line at a time.
+#
+# Usage: batch.sh [myshell]
+################################################################################
+
+. "$(dirname "$0")/check.sh"
+
+check_batch "the command lines of a batch file are executed in order" \
+    'X=1
+/bin/echo $X
+X=2
+/bin/echo $X' \
+    '1
+2'
+check_batch "a batch file ends at quit" \
+    '/bin/echo before
+quit
+/bin/echo after' \
+    'before'
+check_batch "a parallel batch keeps the order of its output" \
+    '/bin/sleep 0.3; /bin/echo first
+/bin/echo second
+/bin/echo third' \
+    'first
+second
+third' -j 3
+check_batch "a parallel batch waits for earlier command lines at a barrier" \
+    '/bin/sleep 0.3; /bin/echo data > file
+cd .
+/bin/cat file' \
+    'data' -j 3
+check_batch "the fork server launches commands" \
+    '/bin/echo one | /bin/cat
+/bin/false
+/bin/echo $?' \
+    'one
+1' --zygote
+check "$? is the exit status of the last command" \
+    '/bin/sh -c "exit 3"; /bin/echo $?' \
+    '3'
+
+exit $failed
@@ -0,0 +1,48 @@
+#!/bin/sh
+################################################################################
+# Helpers shared by the tests of 'myshell'
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Sourced by each test script, with the path to 'myshell' as its first
+# argument. Every command line is executed in a temporary directory (which is
+# also the first directory of PATH) and is given a few seconds to finish, so
+# that a shell which waits forever fails the test instead of hanging.
+################################################################################
+
+shell=$(cd "$(dirname "${1:-./myshell}")" && pwd)/$(basename "${1:-./myshell}")
+failed=0
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+# Execute the shell with some arguments and compare its output with the expected output
+run() {
+    name=$1
+    expected=$2
+    shift 2
+    actual=$(cd "$dir" && PATH="$dir:$PATH" timeout 10 "$shell" "$@" 2>&1)
+    if [ "$actual" = "$expected" ]; then
+        echo "PASS: $name"
+    else
+        echo "FAIL: $name"
+        echo "    expected: $expected"
+        echo "    actual:   $actual"
+        failed=1
+    fi
+}
+
+# Compare the output of a command line with the expected output
+check() {
+    run "$1" "$3" -c "$2"
+}
+
+# Compare the output of a batch file with the expected output (any further arguments are given to the shell first)
+check_batch() {
+    name=$1
+    expected=$3
+    printf '%s\n' "$2" > "$dir/batch"
+    shift 3
+    run "$name" "$expected" "$@" batch
+}
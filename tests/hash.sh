@@ -0,0 +1,36 @@
+#!/bin/sh
+################################################################################
+# Tests of the hash command of 'myshell'
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Executes command lines with 'myshell -c' and compares their output with the
+# expected output. The hits of a remembered command count its executions only.
+#
+# Usage: hash.sh [myshell]
+################################################################################
+
+. "$(dirname "$0")/check.sh"
+
+printf '#!/bin/sh\n' > "$dir/hashed"
+chmod +x "$dir/hashed"
+
+check "finding a command does not count as an execution" \
+    'hash hashed; hash' \
+    "hits	command
+   0	$dir/hashed"
+check "each execution counts" \
+    'hashed; hashed; hash' \
+    "hits	command
+   2	$dir/hashed"
+check "finding a command again resets its hits" \
+    'hashed; hash hashed; hash' \
+    "hits	command
+   0	$dir/hashed"
+check "a command which cannot be found fails" \
+    'hash not-a-command; /bin/echo $?' \
+    "Command 'not-a-command' could not be found.
+1"
+
+exit $failed
@@ -0,0 +1,44 @@
+#!/bin/sh
+################################################################################
+# Tests of pipelines and jobs in 'myshell'
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Executes command lines with 'myshell -c' and compares their output with the
+# expected output. Each command line is given a few seconds to finish, so that
+# a shell which waits forever for a process fails the test instead of hanging.
+#
+# Usage: jobs.sh [myshell]
+################################################################################
+
+. "$(dirname "$0")/check.sh"
+
+check "wait at the end of a pipeline with a background job" \
+    '/bin/sleep 0.3 & ; /bin/true | wait; /bin/echo done' \
+    'done'
+check "fg at the end of a pipeline with a background job" \
+    '/bin/sleep 0.3 & ; /bin/true | fg; /bin/echo done' \
+    '/bin/sleep 0.3 &
+done'
+check "jobs at the end of a pipeline with a background job" \
+    '/bin/sleep 0.3 & ; /bin/true | jobs > /dev/null; /bin/echo done' \
+    'done'
+check "wait at the end of a pipeline which never finishes by itself" \
+    '/usr/bin/yes | wait; /bin/echo done' \
+    'done'
+check "the status of a pipeline is that of its last command" \
+    '/bin/false | wait; /bin/echo $?; /bin/true | /bin/false; /bin/echo $?' \
+    '0
+1'
+check "wait without operands has status 0" \
+    '/bin/false & ; wait; /bin/echo $?' \
+    '0'
+check "wait for a job has the status of the job" \
+    '/bin/false & ; wait %1; /bin/echo $?' \
+    '1'
+check "a job is listed with its own command" \
+    '/bin/sleep 0.3 | /bin/cat & ; jobs > jobs; wait; /bin/sed "s/.*s  //" jobs' \
+    '/bin/sleep 0.3 | /bin/cat &'
+
+exit $failed
@@ -0,0 +1,42 @@
+#!/bin/sh
+################################################################################
+# Tests of pathname expansion in 'myshell'
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Executes command lines with 'myshell -c' in a directory of known files and
+# compares their output with the expected output. Wildcards between quotation
+# marks must only match themselves, even in an argument which also contains
+# wildcards outside of quotation marks.
+#
+# Usage: pathname.sh [myshell]
+################################################################################
+
+. "$(dirname "$0")/check.sh"
+
+touch "$dir/*b1" "$dir/ab1" "$dir/zb1" "$dir/a\\b" "$dir/q?x" "$dir/qzx" "$dir/[x"
+
+check "an unquoted wildcard matches any string" \
+    '/bin/echo *b1' \
+    '*b1 ab1 zb1'
+check "a quoted wildcard is literal next to an unquoted wildcard" \
+    '/bin/echo "*"b*' \
+    '*b1'
+check "a quoted ? is literal next to an unquoted wildcard" \
+    '/bin/echo q"?"*' \
+    'q?x'
+check "a quoted [ is literal next to an unquoted wildcard" \
+    '/bin/echo "["*' \
+    '[x'
+check "a pattern which matches nothing is unchanged" \
+    '/bin/echo "*"z* "*"' \
+    '*z* *'
+check "a backslash is an ordinary character" \
+    '/bin/echo a\* a\b' \
+    'a\b a\b'
+check "an assignment is not expanded" \
+    'X="*"*; /bin/echo "$X"' \
+    '**'
+
+exit $failed
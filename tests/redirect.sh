@@ -0,0 +1,48 @@
+#!/bin/sh
+################################################################################
+# Tests of redirections, here-documents and here-strings in 'myshell'
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Executes command lines and batch files with 'myshell' and compares their
+# output with the expected output.
+#
+# Usage: redirect.sh [myshell]
+################################################################################
+
+. "$(dirname "$0")/check.sh"
+
+check "output is redirected to a file" \
+    '/bin/echo one > out; /bin/echo two >> out; /bin/cat out' \
+    'one
+two'
+check "input is redirected from a file" \
+    '/bin/echo text > in; /bin/cat < in' \
+    'text'
+check "redirections are applied from left to right" \
+    '/bin/sh -c "echo error 1>&2" > out 2>&1; /bin/cat out; /bin/sh -c "echo error 1>&2" 2>&1 > out; /usr/bin/wc -c < out' \
+    'error
+error
+0'
+check "a here-string is followed by a new-line character" \
+    '/bin/cat <<< "a b"' \
+    'a b'
+check_batch "a here-document expands variables" \
+    'X=value
+/bin/cat <<EOF
+$X line
+EOF' \
+    'value line'
+check_batch "a quoted delimiter keeps the here-document unchanged" \
+    'X=value
+/bin/cat << "EOF"
+$X line
+EOF' \
+    '$X line'
+check_batch "an internal command writes to a redirected file" \
+    'echo internal > out
+/bin/cat out' \
+    'internal '
+
+exit $failed
@@ -0,0 +1,40 @@
+#!/bin/sh
+################################################################################
+# Tests of the shell server of 'myshell'
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Starts a shell server in a temporary directory, executes command lines with
+# 'myshell --client' and compares their output with the expected output.
+#
+# Usage: server.sh [myshell]
+################################################################################
+
+. "$(dirname "$0")/check.sh"
+
+"$shell" --serve "$dir/socket" &
+server=$!
+trap 'kill $server 2>/dev/null; wait $server; rm -rf "$dir"' EXIT
+
+# Wait for the server to listen
+i=0
+while [ ! -S "$dir/socket" ] && [ $i -lt 50 ]; do
+    sleep 0.1
+    i=$((i + 1))
+done
+
+run "a session executes a command line" \
+    'hello' --client "$dir/socket" -c '/bin/echo hello'
+run "a session uses the current working directory of the client" \
+    "$dir" --client "$dir/socket" -c '/bin/pwd'
+TEST_VALUE=client
+export TEST_VALUE
+run "a session uses the environment of the client" \
+    'client' --client "$dir/socket" -c '/bin/echo $TEST_VALUE'
+run "a session sets a variable" \
+    'set' --client "$dir/socket" -c 'X=set; /bin/echo $X'
+run "a later session does not see the variable" \
+    'unset' --client "$dir/socket" -c '/bin/echo ${X}unset'
+
+exit $failed
@@ -0,0 +1,42 @@
+#!/bin/sh
+################################################################################
+# Tests of command substitution in 'myshell'
+#-------------------------------------------------------------------------------
+# Author:	Joshua Spence
+# SID:		308216350
+#===============================================================================
+# Executes command lines with 'myshell -c' and compares their output with the
+# expected output. A command substitution which uses an internal command that
+# changes the state of the shell must not change the state of the shell which
+# expands it.
+#
+# Usage: substitution.sh [myshell]
+################################################################################
+
+. "$(dirname "$0")/check.sh"
+
+check "echo is executed by the shell" \
+    '/bin/echo [$(echo hi)]' \
+    '[hi ]'
+check "exec does not replace the shell" \
+    '/bin/echo [$(exec /bin/echo hi)]; /bin/echo after' \
+    '[hi]
+after'
+check "cd does not change the directory of the shell" \
+    '/bin/echo [$(cd /; /bin/pwd)]; /bin/pwd' \
+    "[/]
+$dir"
+check "an assignment does not set the variable in the shell" \
+    'X=1; /bin/echo [$(X=2; /bin/echo $X)]; /bin/echo $X' \
+    '[2]
+1'
+check "export does not change the environment of the shell" \
+    '/bin/echo [$(export Y=1)]; /usr/bin/env | /bin/grep -c ^Y=' \
+    '[]
+0'
+check "quit does not make the shell quit" \
+    '/bin/echo [$(quit)]; /bin/echo after' \
+    '[]
+after'
+
+exit $failed